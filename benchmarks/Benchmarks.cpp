@@ -30,3 +30,1118 @@ TEST_CASE ("Boot performance")
         });
     };
 }
+
+TEST_CASE ("EQ processing")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize     = 512;
+
+    const std::array<BiquadCoefficients<float>, 3> coeffs { {
+        FilterDesign::makeLowShelf  (sampleRate, 200.0f, 4.0f, 0.707f),
+        FilterDesign::makePeakBell  (sampleRate, 1000.0f, -3.0f, 1.0f),
+        FilterDesign::makeHighShelf (sampleRate, 8000.0f, 2.0f, 0.707f) } };
+
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    juce::Random random (1);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    // Both variants refill the buffer from the same input every run so the
+    // signal never decays into denormals.
+    juce::ScopedNoDenormals noDenormals;
+
+    BENCHMARK_ADVANCED ("Dual MonoChain, separate gain pass (stereo, 512)")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        using MonoFilter = juce::dsp::IIR::Filter<float>;
+        using MonoChain  = juce::dsp::ProcessorChain<MonoFilter, MonoFilter, MonoFilter>;
+
+        MonoChain left, right;
+        for (auto* chain : { &left, &right })
+        {
+            auto toJuce = [] (const BiquadCoefficients<float>& c) {
+                return new juce::dsp::IIR::Coefficients<float> (c.b0, c.b1, c.b2, 1.0f, c.a1, c.a2);
+            };
+            chain->get<0>().coefficients = toJuce (coeffs[0]);
+            chain->get<1>().coefficients = toJuce (coeffs[1]);
+            chain->get<2>().coefficients = toJuce (coeffs[2]);
+            chain->prepare ({ sampleRate, (juce::uint32) blockSize, 1 });
+        }
+
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> gain;
+        gain.reset (sampleRate, 0.05);
+        gain.setCurrentAndTargetValue (0.5f);
+
+        meter.measure ([&] {
+            buffer.makeCopyOf (input, true);
+
+            juce::dsp::AudioBlock<float> block (buffer);
+            auto leftBlock  = block.getSingleChannelBlock (0);
+            auto rightBlock = block.getSingleChannelBlock (1);
+            left.process (juce::dsp::ProcessContextReplacing<float> (leftBlock));
+            right.process (juce::dsp::ProcessContextReplacing<float> (rightBlock));
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const float g = gain.getNextValue();
+                for (int ch = 0; ch < 2; ++ch)
+                    buffer.getWritePointer (ch)[i] *= g;
+            }
+            return buffer.getSample (0, blockSize - 1);
+        });
+    };
+
+    BENCHMARK_ADVANCED ("BiquadCascade, fused gain (stereo, 512)")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        BiquadCascade<float, 3> cascade;
+        for (int stage = 0; stage < 3; ++stage)
+            cascade.setCoefficients (stage, coeffs[(size_t) stage]);
+
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> gain;
+        gain.reset (sampleRate, 0.05);
+        gain.setCurrentAndTargetValue (0.5f);
+
+        meter.measure ([&] {
+            buffer.makeCopyOf (input, true);
+            cascade.process (buffer.getArrayOfWritePointers(), 2, blockSize, [&] { return gain.getNextValue(); });
+            return buffer.getSample (0, blockSize - 1);
+        });
+    };
+
+    BENCHMARK_ADVANCED ("SvfCascade, fused gain (stereo, 512)")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        SvfCascade<float, 3> cascade;
+        cascade.setCoefficients (0, FilterDesign::makeSvfBand (BandType::LowShelf, sampleRate, 200.0f, 4.0f, 0.707f));
+        cascade.setCoefficients (1, FilterDesign::makeSvfBand (BandType::PeakBell, sampleRate, 1000.0f, -3.0f, 1.0f));
+        cascade.setCoefficients (2, FilterDesign::makeSvfBand (BandType::HighShelf, sampleRate, 8000.0f, 2.0f, 0.707f));
+
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> gain;
+        gain.reset (sampleRate, 0.05);
+        gain.setCurrentAndTargetValue (0.5f);
+
+        meter.measure ([&] {
+            buffer.makeCopyOf (input, true);
+            cascade.process (buffer.getArrayOfWritePointers(), 2, blockSize, [&] { return gain.getNextValue(); });
+            return buffer.getSample (0, blockSize - 1);
+        });
+    };
+}
+
+TEST_CASE ("Coefficient calculation")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr std::array<BandType, 3> bandTypes { BandType::LowShelf, BandType::PeakBell, BandType::HighShelf };
+
+    BiquadCascade<float, 3> cascade;
+
+    // Inputs move every run so nothing can be hoisted out of the loop
+    float freq = 100.0f;
+    auto nextFreq = [&freq] { return freq = freq > 10000.0f ? 100.0f : freq * 1.01f; };
+
+    BENCHMARK ("Cookbook formulas, all three bands")
+    {
+        const float f = nextFreq();
+        for (int band = 0; band < 3; ++band)
+            cascade.setCoefficients (band, FilterDesign::makeBand (bandTypes[(size_t) band], sampleRate, f, 3.0f, 0.707f));
+        return cascade.getCoefficients (2, 0).b0;
+    };
+
+    CoefficientKernel<float, 3> kernel;
+
+    BENCHMARK ("CoefficientKernel, all three bands")
+    {
+        const float f = nextFreq();
+        for (int band = 0; band < 3; ++band)
+            kernel.setBand (band, f, 3.0f, 0.707f);
+        kernel.update<BiquadTopology> (bandTypes, sampleRate, cascade);
+        return cascade.getCoefficients (2, 0).b0;
+    };
+
+    BENCHMARK ("CoefficientKernel, one dirty band")
+    {
+        kernel.setBand (1, nextFreq(), 3.0f, 0.707f);
+        kernel.update<BiquadTopology> (bandTypes, sampleRate, cascade);
+        return cascade.getCoefficients (1, 0).b0;
+    };
+}
+
+TEST_CASE ("EQ automation")
+{
+    constexpr int blockSize = 512;
+
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, blockSize);
+
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    juce::Random random (2);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    juce::MidiBuffer midi;
+
+    BENCHMARK_ADVANCED ("processBlock, static EQ (stereo, 512)")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        meter.measure ([&] {
+            buffer.makeCopyOf (input, true);
+            plugin.processBlock (buffer, midi);
+            return buffer.getSample (0, blockSize - 1);
+        });
+    };
+
+    BENCHMARK_ADVANCED ("processBlock, all bands sweeping (stereo, 512)")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        // A new frequency, gain and Q for every band every block keeps all
+        // three smoothers ramping for the whole run.
+        float phase = 0.0f;
+
+        meter.measure ([&] {
+            phase = std::fmod (phase + 0.01f, 1.0f);
+            for (int band = 0; band < PluginProcessor::numBands; ++band)
+                for (const auto param : { PluginProcessor::BandParameter::Freq, PluginProcessor::BandParameter::Gain, PluginProcessor::BandParameter::Q })
+                    plugin.queueParameterEvent (PluginProcessor::bandParameterIndex (band, param), 0, 0.25f + 0.5f * phase);
+
+            buffer.makeCopyOf (input, true);
+            plugin.processBlock (buffer, midi);
+            return buffer.getSample (0, blockSize - 1);
+        });
+    };
+}
+
+TEST_CASE ("Dynamic EQ")
+{
+    // Every band dynamic and compressing, against the static EQ above
+    constexpr int blockSize = 512;
+
+    PluginProcessor plugin;
+    for (int band = 0; band < PluginProcessor::numBands; ++band)
+    {
+        for (auto [which, value] : { std::pair { PluginProcessor::BandParameter::Dynamic, 1.0f },
+                                     std::pair { PluginProcessor::BandParameter::Threshold, -40.0f },
+                                     std::pair { PluginProcessor::BandParameter::Ratio, 4.0f } })
+        {
+            auto* param = plugin.apvts.getParameter (PluginProcessor::getParameterID (PluginProcessor::bandParameterIndex (band, which)));
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+        }
+    }
+    plugin.prepareToPlay (48000.0, blockSize);
+
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    juce::Random random (6);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    juce::MidiBuffer midi;
+
+    BENCHMARK ("processBlock, all bands dynamic (stereo, 512)")
+    {
+        buffer.makeCopyOf (input, true);
+        plugin.processBlock (buffer, midi);
+        return buffer.getSample (0, blockSize - 1);
+    };
+}
+
+TEST_CASE ("Channel count")
+{
+    // Four channels share one cascade, so 6 and 12 channels should cost far
+    // less than 3x and 6x stereo
+    constexpr int blockSize = 512;
+
+    juce::MidiBuffer midi;
+    juce::Random random (7);
+
+    for (const auto& [set, name] : { std::pair { juce::AudioChannelSet::stereo(), "processBlock, 2 channels (512)" },
+                                     std::pair { juce::AudioChannelSet::create5point1(), "processBlock, 6 channels (512)" },
+                                     std::pair { juce::AudioChannelSet::create7point1point4(), "processBlock, 12 channels (512)" } })
+    {
+        PluginProcessor plugin;
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (set);
+        layout.inputBuses.add (juce::AudioChannelSet::disabled()); // no sidechain
+        layout.outputBuses.add (set);
+        plugin.setBusesLayout (layout);
+        plugin.prepareToPlay (48000.0, blockSize);
+
+        const int numChannels = set.size();
+        juce::AudioBuffer<float> input (numChannels, blockSize), buffer (numChannels, blockSize);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        BENCHMARK (name)
+        {
+            buffer.makeCopyOf (input, true);
+            plugin.processBlock (buffer, midi);
+            return buffer.getSample (0, blockSize - 1);
+        };
+    }
+}
+
+TEST_CASE ("Oversampling modes")
+{
+    constexpr int blockSize = 512;
+
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    juce::Random random (3);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    juce::MidiBuffer midi;
+
+    const std::pair<int, const char*> modes[] {
+        { 0, "processBlock, 1x (stereo, 512)" },
+        { 1, "processBlock, 2x (stereo, 512)" },
+        { 2, "processBlock, 4x (stereo, 512)" }
+    };
+
+    for (const auto& [order, name] : modes)
+    {
+        for (const auto filter : { PluginProcessor::OversamplingFilter::PolyphaseIIR, PluginProcessor::OversamplingFilter::LinearPhaseFIR })
+        {
+            // The filter choice makes no difference at 1x
+            if (order == 0 && filter == PluginProcessor::OversamplingFilter::LinearPhaseFIR)
+                continue;
+
+            PluginProcessor plugin;
+            for (auto [paramID, index] : { std::pair { "oversampling", order }, std::pair { "oversamplingFilter", (int) filter } })
+            {
+                auto* param = plugin.apvts.getParameter (paramID);
+                param->setValueNotifyingHost (param->convertTo0to1 ((float) index));
+            }
+            plugin.prepareToPlay (48000.0, blockSize);
+
+            const auto label = juce::String (name) + (order == 0 ? "" : filter == PluginProcessor::OversamplingFilter::PolyphaseIIR ? ", IIR" : ", FIR");
+
+            BENCHMARK (label.toStdString())
+            {
+                buffer.makeCopyOf (input, true);
+                plugin.processBlock (buffer, midi);
+                return buffer.getSample (0, blockSize - 1);
+            };
+        }
+    }
+}
+
+TEST_CASE ("Linear-phase EQ")
+{
+    // Cost per sample should not depend on the host block size
+    PluginProcessor plugin;
+    auto* phaseMode = plugin.apvts.getParameter ("phaseMode");
+    phaseMode->setValueNotifyingHost (phaseMode->convertTo0to1 ((float) PluginProcessor::PhaseMode::Linear));
+    plugin.prepareToPlay (48000.0, 4096);
+
+    juce::MidiBuffer midi;
+    juce::Random random (4);
+
+    for (const int blockSize : { 64, 512, 4096 })
+    {
+        juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        // Always 4096 samples per run, so the timings compare directly
+        BENCHMARK ("processBlock, linear phase, 4096 samples in blocks of " + std::to_string (blockSize))
+        {
+            for (int done = 0; done < 4096; done += blockSize)
+            {
+                buffer.makeCopyOf (input, true);
+                plugin.processBlock (buffer, midi);
+            }
+            return buffer.getSample (0, blockSize - 1);
+        };
+    }
+}
+
+TEST_CASE ("Transient shaper")
+{
+    // Should cost less per sample than the three-band cascade it follows
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize     = 512;
+
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    juce::Random random (5);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    juce::ScopedNoDenormals noDenormals;
+
+    BENCHMARK_ADVANCED ("BiquadCascade, reference (stereo, 512)")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        BiquadCascade<float, 3> cascade;
+        cascade.setCoefficients (0, FilterDesign::makeLowShelf (sampleRate, 200.0f, 4.0f, 0.707f));
+        cascade.setCoefficients (1, FilterDesign::makePeakBell (sampleRate, 1000.0f, -3.0f, 1.0f));
+        cascade.setCoefficients (2, FilterDesign::makeHighShelf (sampleRate, 8000.0f, 2.0f, 0.707f));
+
+        meter.measure ([&] {
+            buffer.makeCopyOf (input, true);
+            cascade.process (buffer.getArrayOfWritePointers(), 2, blockSize, [] { return 0.5f; });
+            return buffer.getSample (0, blockSize - 1);
+        });
+    };
+
+    for (const auto [attackDb, sustainDb, name] : { std::tuple { 0.0f, 0.0f, "TransientShaper, idle (stereo, 512)" },
+                                                    std::tuple { 6.0f, -4.0f, "TransientShaper, shaping (stereo, 512)" } })
+    {
+        TransientShaper<float> shaper;
+        shaper.setAmounts (attackDb, sustainDb);
+        shaper.prepare (sampleRate);
+
+        BENCHMARK (name)
+        {
+            buffer.makeCopyOf (input, true);
+            shaper.process (buffer.getArrayOfWritePointers(), 2, blockSize);
+            return buffer.getSample (0, blockSize - 1);
+        };
+    }
+}
+
+TEST_CASE ("Processing precision")
+{
+    // The whole IIR path in float and in double, on the 20 Hz shelf at
+    // 192 kHz that double precision is for
+    constexpr int blockSize = 512;
+
+    juce::MidiBuffer midi;
+    juce::Random random (8);
+
+    auto makePlugin = [] (bool useDouble) {
+        auto plugin = std::make_unique<PluginProcessor>();
+        for (auto [id, value] : { std::pair { "lowFreq", 20.0f }, std::pair { "lowGain", 12.0f } })
+        {
+            auto* param = plugin->apvts.getParameter (id);
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+        }
+
+        if (useDouble)
+            plugin->setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+
+        plugin->prepareToPlay (192000.0, blockSize);
+        return plugin;
+    };
+
+    auto floatPlugin  = makePlugin (false);
+    auto doublePlugin = makePlugin (true);
+
+    juce::AudioBuffer<float> floatInput (2, blockSize), floatBuffer (2, blockSize);
+    juce::AudioBuffer<double> doubleInput (2, blockSize), doubleBuffer (2, blockSize);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        for (int i = 0; i < blockSize; ++i)
+        {
+            const auto s = random.nextFloat() * 2.0f - 1.0f;
+            floatInput.setSample (ch, i, s);
+            doubleInput.setSample (ch, i, s);
+        }
+    }
+
+    BENCHMARK ("processBlock, float (stereo, 512)")
+    {
+        floatBuffer.makeCopyOf (floatInput, true);
+        floatPlugin->processBlock (floatBuffer, midi);
+        return floatBuffer.getSample (0, blockSize - 1);
+    };
+
+    BENCHMARK ("processBlock, double (stereo, 512)")
+    {
+        doubleBuffer.makeCopyOf (doubleInput, true);
+        doublePlugin->processBlock (doubleBuffer, midi);
+        return doubleBuffer.getSample (0, blockSize - 1);
+    };
+}
+
+TEST_CASE ("Stereo modes")
+{
+    // M/S encodes and decodes inside the filter loop, so every mode should
+    // cost about the same as linked
+    constexpr int blockSize = 512;
+
+    juce::MidiBuffer midi;
+    juce::Random random (9);
+
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    for (const auto [mode, name] : { std::pair { 0, "processBlock, linked (stereo, 512)" },
+                                     std::pair { 1, "processBlock, mid/side (stereo, 512)" },
+                                     std::pair { 2, "processBlock, left/right (stereo, 512)" } })
+    {
+        PluginProcessor plugin;
+        auto* param = plugin.apvts.getParameter ("stereoMode");
+        param->setValueNotifyingHost (param->convertTo0to1 ((float) mode));
+        plugin.prepareToPlay (48000.0, blockSize);
+
+        BENCHMARK (name)
+        {
+            buffer.makeCopyOf (input, true);
+            plugin.processBlock (buffer, midi);
+            return buffer.getSample (0, blockSize - 1);
+        };
+    }
+}
+
+TEST_CASE ("Idle instance")
+{
+    // A muted track: once the tail has rung out a silent block costs one
+    // peak scan per channel, against the full chain on the same silence
+    constexpr int blockSize = 512;
+
+    juce::MidiBuffer midi;
+    juce::AudioBuffer<float> buffer (2, blockSize);
+
+    auto makePlugin = [] {
+        auto plugin = std::make_unique<PluginProcessor>();
+        auto* param = plugin->apvts.getParameter ("midGain");
+        param->setValueNotifyingHost (param->convertTo0to1 (6.0f));
+        plugin->prepareToPlay (48000.0, blockSize);
+        return plugin;
+    };
+
+    auto idle = makePlugin();
+    for (int block = 0; block < 100; ++block)
+    {
+        buffer.clear();
+        idle->processBlock (buffer, midi);
+    }
+
+    // A small click at the top of every block keeps the other one processing
+    auto busy = makePlugin();
+    juce::AudioBuffer<float> quiet (2, blockSize);
+    juce::Random random (10);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            quiet.setSample (ch, i, i == 0 ? 1.0e-3f : (random.nextFloat() - 0.5f) * 1.0e-6f);
+
+    BENCHMARK ("processBlock, silent and bypassed (stereo, 512)")
+    {
+        buffer.clear();
+        idle->processBlock (buffer, midi);
+        return buffer.getSample (0, blockSize - 1);
+    };
+
+    BENCHMARK ("processBlock, near-silent and processing (stereo, 512)")
+    {
+        buffer.makeCopyOf (quiet, true);
+        busy->processBlock (buffer, midi);
+        return buffer.getSample (0, blockSize - 1);
+    };
+}
+
+// Where the CSV benchmarks write: the file named by environmentVariable if
+// it is set, stdout otherwise
+static std::ostream& openCsv (const char* environmentVariable, std::ofstream& file)
+{
+    const auto path = juce::SystemStats::getEnvironmentVariable (environmentVariable, {});
+    if (path.isNotEmpty())
+        file.open (path.toStdString());
+
+    return file.is_open() ? file : std::cout;
+}
+
+TEST_CASE ("Throughput matrix")
+{
+    // The whole audio path over block size, sample rate, channel count and
+    // automation, as ns per sample frame and real-time factor. One CSV row
+    // per configuration goes to stdout, or to the file named by the
+    // THROUGHPUT_CSV environment variable, so runs can be compared by script.
+    // Each configuration processes half a second of audio per pass and keeps
+    // the fastest of five passes.
+    constexpr int numPasses = 5;
+
+    std::ofstream csvFile;
+    auto& csv = openCsv ("THROUGHPUT_CSV", csvFile);
+
+    csv << "channels,sample_rate,block_size,automation,ns_per_sample,realtime_factor\n";
+
+    juce::MidiBuffer midi;
+    juce::Random random (12);
+
+    for (const auto& bus : { juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo() })
+    {
+        for (const double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        {
+            for (const int blockSize : { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 })
+            {
+                for (const bool automated : { false, true })
+                {
+                    PluginProcessor plugin;
+                    juce::AudioProcessor::BusesLayout layout;
+                    layout.inputBuses.add (bus);
+                    layout.inputBuses.add (juce::AudioChannelSet::disabled()); // no sidechain
+                    layout.outputBuses.add (bus);
+                    plugin.setBusesLayout (layout);
+                    plugin.prepareToPlay (sampleRate, blockSize);
+
+                    const int numChannels = bus.size();
+                    juce::AudioBuffer<float> input (numChannels, blockSize), buffer (numChannels, blockSize);
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        for (int i = 0; i < blockSize; ++i)
+                            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+                    const int numBlocks = juce::jmax (1, juce::roundToInt (sampleRate * 0.5 / blockSize));
+                    float phase = 0.0f;
+
+                    // Automated moves every band's frequency, gain and Q at
+                    // the top of each block, like a host sending a curve
+                    auto runPass = [&] {
+                        for (int block = 0; block < numBlocks; ++block)
+                        {
+                            if (automated)
+                            {
+                                phase = std::fmod (phase + 0.001f, 1.0f);
+                                for (int band = 0; band < PluginProcessor::numBands; ++band)
+                                    for (const auto param : { PluginProcessor::BandParameter::Freq, PluginProcessor::BandParameter::Gain, PluginProcessor::BandParameter::Q })
+                                        plugin.queueParameterEvent (PluginProcessor::bandParameterIndex (band, param), 0, 0.25f + 0.5f * phase);
+                            }
+
+                            buffer.makeCopyOf (input, true);
+                            plugin.processBlock (buffer, midi);
+                        }
+                    };
+
+                    runPass();
+
+                    auto fastest = std::chrono::steady_clock::duration::max();
+                    for (int pass = 0; pass < numPasses; ++pass)
+                    {
+                        const auto start = std::chrono::steady_clock::now();
+                        runPass();
+                        fastest = std::min (fastest, std::chrono::steady_clock::now() - start);
+                    }
+
+                    const auto seconds   = std::chrono::duration<double> (fastest).count();
+                    const auto numFrames = (double) numBlocks * blockSize;
+
+                    csv << numChannels << ',' << sampleRate << ',' << blockSize << ','
+                        << (automated ? "automated" : "static") << ','
+                        << seconds * 1.0e9 / numFrames << ','
+                        << numFrames / sampleRate / seconds << '\n';
+                }
+            }
+        }
+    }
+}
+
+// A host's audio worker group: persistent threads that each run their share
+// of the session once per cycle, the calling thread included. They spin
+// between cycles rather than sleep, so waking them doesn't swamp the timing.
+class WorkerGroup
+{
+public:
+    WorkerGroup (int numThreadsToUse, std::function<void (int worker)> workToDo)
+        : numThreads (numThreadsToUse), work (std::move (workToDo))
+    {
+        for (int worker = 1; worker < numThreads; ++worker)
+        {
+            threads.emplace_back ([this, worker] {
+                for (int seen = 0;;)
+                {
+                    int cycle;
+                    while ((cycle = generation.load (std::memory_order_acquire)) == seen)
+                        std::this_thread::yield();
+
+                    if (cycle < 0)
+                        return;
+
+                    seen = cycle;
+                    work (worker);
+                    finished.fetch_add (1, std::memory_order_acq_rel);
+                }
+            });
+        }
+    }
+
+    ~WorkerGroup()
+    {
+        generation.store (-1, std::memory_order_release);
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    void runCycle()
+    {
+        finished.store (0, std::memory_order_relaxed);
+        generation.fetch_add (1, std::memory_order_release);
+        work (0);
+
+        while (finished.load (std::memory_order_acquire) < numThreads - 1)
+            std::this_thread::yield();
+    }
+
+private:
+    const int numThreads;
+    std::function<void (int)> work;
+    std::atomic<int> generation { 0 }, finished { 0 };
+    std::vector<std::thread> threads;
+};
+
+TEST_CASE ("Session scaling")
+{
+    // N stereo instances at 48 kHz and 256-sample blocks, like a full
+    // session, processed round-robin on one thread and then spread across
+    // one worker per physical core. Per-instance cost that climbs with N
+    // means instances are fighting over cache. One CSV row per run, to
+    // stdout or the file named by SCALING_CSV.
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize     = 256;
+    constexpr int numCycles     = 100;
+
+    std::ofstream csvFile;
+    auto& csv = openCsv ("SCALING_CSV", csvFile);
+    csv << "instances,threads,ns_per_instance_block,realtime_factor\n";
+
+    struct Track
+    {
+        std::unique_ptr<PluginProcessor> plugin;
+        juce::AudioBuffer<float> buffer { 2, blockSize };
+        juce::MidiBuffer midi;
+    };
+
+    juce::AudioBuffer<float> input (2, blockSize);
+    juce::Random random (13);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    const int numCores = juce::jmax (1, juce::SystemStats::getNumPhysicalCpus());
+
+    for (const int numInstances : { 1, 8, 32, 64, 128, 256 })
+    {
+        // Every track a different curve, as in a real mix
+        std::vector<Track> tracks ((size_t) numInstances);
+        for (auto& track : tracks)
+        {
+            track.plugin = std::make_unique<PluginProcessor>();
+            for (int band = 0; band < PluginProcessor::numBands; ++band)
+            {
+                auto* gain = track.plugin->apvts.getParameter (PluginProcessor::getParameterID (PluginProcessor::bandParameterIndex (band, PluginProcessor::BandParameter::Gain)));
+                gain->setValueNotifyingHost (random.nextFloat());
+            }
+            track.plugin->prepareToPlay (sampleRate, blockSize);
+        }
+
+        for (const int numThreads : { 1, numCores })
+        {
+            if (numThreads == numCores && numCores == 1)
+                continue;
+
+            // Strided, so every thread gets an even share
+            WorkerGroup workers (numThreads, [&] (int worker) {
+                for (size_t i = (size_t) worker; i < tracks.size(); i += (size_t) numThreads)
+                {
+                    auto& track = tracks[i];
+                    track.buffer.makeCopyOf (input, true);
+                    track.plugin->processBlock (track.buffer, track.midi);
+                }
+            });
+
+            workers.runCycle();
+
+            const auto start = std::chrono::steady_clock::now();
+            for (int cycle = 0; cycle < numCycles; ++cycle)
+                workers.runCycle();
+            const auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+            csv << numInstances << ',' << numThreads << ','
+                << seconds * 1.0e9 / (numCycles * numInstances) << ','
+                << numCycles * blockSize / sampleRate / seconds << '\n';
+        }
+    }
+}
+
+TEST_CASE ("State save and load")
+{
+    // Loading alternates between two states, so every parameter changes on
+    // every run, as when a host opens a project or steps through undo
+    PluginProcessor plugin;
+
+    auto makeStates = [&plugin] (auto&& save) {
+        std::array<juce::MemoryBlock, 2> states;
+        for (size_t i = 0; i < states.size(); ++i)
+        {
+            juce::Random random ((juce::int64) i + 1);
+            for (auto* param : plugin.getParameters())
+                param->setValueNotifyingHost (random.nextFloat());
+            save (states[i]);
+        }
+        return states;
+    };
+
+    const auto binaryStates = makeStates ([&plugin] (juce::MemoryBlock& block) { plugin.getStateInformation (block); });
+    const auto xmlStates    = makeStates ([&plugin] (juce::MemoryBlock& block) {
+        std::unique_ptr<juce::XmlElement> xml (plugin.apvts.copyState().createXml());
+        juce::AudioProcessor::copyXmlToBinary (*xml, block);
+    });
+
+    juce::MemoryBlock saved;
+
+    BENCHMARK ("getStateInformation, binary")
+    {
+        plugin.getStateInformation (saved);
+        return saved.getSize();
+    };
+
+    BENCHMARK ("getStateInformation, XML (before the binary format)")
+    {
+        std::unique_ptr<juce::XmlElement> xml (plugin.apvts.copyState().createXml());
+        juce::AudioProcessor::copyXmlToBinary (*xml, saved);
+        return saved.getSize();
+    };
+
+    size_t next = 0;
+
+    BENCHMARK ("setStateInformation, binary")
+    {
+        const auto& state = binaryStates[next++ % binaryStates.size()];
+        plugin.setStateInformation (state.getData(), (int) state.getSize());
+        return plugin.getParameters()[0]->getValue();
+    };
+
+    BENCHMARK ("setStateInformation, XML")
+    {
+        const auto& state = xmlStates[next++ % xmlStates.size()];
+        plugin.setStateInformation (state.getData(), (int) state.getSize());
+        return plugin.getParameters()[0]->getValue();
+    };
+}
+
+TEST_CASE ("Program switching")
+{
+    // A program change lands at the top of the next block, so its latency
+    // is one block. What it costs is that block over an ordinary one, and
+    // against loading the same settings as a saved state.
+    constexpr int blockSize  = 64;
+    constexpr int numPresets = 2000;
+
+    PluginProcessor plugin;
+    juce::Random random (14);
+
+    juce::StringArray ids;
+    for (int i = 0; i < PluginProcessor::NumParameters; ++i)
+        ids.add (PluginProcessor::getParameterID (i));
+
+    std::vector<PresetBank::Preset> presets ((size_t) numPresets);
+    for (auto& preset : presets)
+    {
+        for (const auto& id : ids)
+        {
+            auto* param = plugin.apvts.getParameter (id);
+            preset.values.push_back (param->convertFrom0to1 (random.nextFloat()));
+        }
+    }
+
+    juce::TemporaryFile temp (".mjpb");
+    {
+        juce::FileOutputStream out (temp.getFile());
+        PresetBank::write (out, ids, presets);
+    }
+
+    BENCHMARK ("PresetBank::open, 2000 presets")
+    {
+        PresetBank bank;
+        return bank.open (temp.getFile());
+    };
+
+    plugin.loadPresetBank (temp.getFile());
+    plugin.prepareToPlay (48000.0, blockSize);
+
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    juce::MidiBuffer midi;
+
+    BENCHMARK ("processBlock, no change (stereo, 64)")
+    {
+        buffer.makeCopyOf (input, true);
+        plugin.processBlock (buffer, midi);
+        return buffer.getSample (0, blockSize - 1);
+    };
+
+    int program = 0;
+
+    BENCHMARK ("setCurrentProgram + processBlock (stereo, 64)")
+    {
+        program = (program + 997) % numPresets;
+        plugin.setCurrentProgram (program);
+        buffer.makeCopyOf (input, true);
+        plugin.processBlock (buffer, midi);
+        return buffer.getSample (0, blockSize - 1);
+    };
+
+    std::array<juce::MemoryBlock, 2> states;
+    for (size_t i = 0; i < states.size(); ++i)
+    {
+        plugin.setCurrentProgram ((int) i);
+        buffer.makeCopyOf (input, true);
+        plugin.processBlock (buffer, midi);
+        plugin.getStateInformation (states[i]);
+    }
+
+    size_t next = 0;
+
+    BENCHMARK ("setStateInformation + processBlock (stereo, 64)")
+    {
+        const auto& state = states[next++ % states.size()];
+        plugin.setStateInformation (state.getData(), (int) state.getSize());
+        buffer.makeCopyOf (input, true);
+        plugin.processBlock (buffer, midi);
+        return buffer.getSample (0, blockSize - 1);
+    };
+}
+
+TEST_CASE ("Spectrum analyser")
+{
+    // Audio side: what an open analyser adds to processBlock, which should be
+    // no more than the two mono mixdowns into the FIFOs
+    constexpr int blockSize = 512;
+
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, blockSize);
+
+    juce::Random random (20);
+    juce::AudioBuffer<float> input (2, blockSize), buffer (2, blockSize);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+    juce::MidiBuffer midi;
+    auto& pre  = plugin.getAnalyserFifo (false);
+    auto& post = plugin.getAnalyserFifo (true);
+
+    BENCHMARK ("processBlock, analyser closed (stereo, 512)")
+    {
+        buffer.makeCopyOf (input, true);
+        plugin.processBlock (buffer, midi);
+        return buffer.getSample (0, blockSize - 1);
+    };
+
+    plugin.setAnalyserEnabled (true);
+
+    // Emptied every time, as the editor would, so the pushes never take the
+    // cheaper path of a full FIFO
+    BENCHMARK ("processBlock, analyser open (stereo, 512)")
+    {
+        pre.clear();
+        post.clear();
+        buffer.makeCopyOf (input, true);
+        plugin.processBlock (buffer, midi);
+        return buffer.getSample (0, blockSize - 1);
+    };
+
+    BENCHMARK ("AnalyserFifo::push (stereo, 512)")
+    {
+        pre.clear();
+        return pre.push (input.getArrayOfReadPointers(), 2, blockSize);
+    };
+
+    // UI side: one frame is draining a frame's worth of audio from both FIFOs,
+    // two FFTs and a repaint at the size the editor shows it
+    constexpr int samplesPerFrame = 48000 / SpectrumAnalyser::refreshRateHz;
+
+    SpectrumAnalyser analyser (plugin);
+    analyser.setSize (1000, 160);
+    juce::Image image (juce::Image::ARGB, analyser.getWidth(), analyser.getHeight(), true);
+
+    auto frame = [&] {
+        for (int start = 0; start < samplesPerFrame; start += blockSize)
+        {
+            const int num = juce::jmin (blockSize, samplesPerFrame - start);
+            pre.push (input.getArrayOfReadPointers(), 2, num);
+            post.push (input.getArrayOfReadPointers(), 2, num);
+        }
+
+        analyser.updateSpectra();
+        juce::Graphics g (image);
+        analyser.paintEntireComponent (g, false);
+    };
+
+    BENCHMARK ("Analyser frame, FFTs only")
+    {
+        analyser.updateSpectra();
+        return pre.getNumReady();
+    };
+
+    BENCHMARK ("Analyser frame, FFTs and paint (1000 x 160)")
+    {
+        frame();
+        return image.getPixelAt (500, 80).getARGB();
+    };
+
+    // The same frame as a share of one core at the refresh rate
+    constexpr int numFrames = 300;
+    const auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < numFrames; ++i)
+        frame();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    const auto frameSeconds = elapsed.count() / numFrames;
+    std::cout << "Analyser: " << frameSeconds * 1.0e3 << " ms a frame, "
+              << frameSeconds * SpectrumAnalyser::refreshRateHz * 100.0 << " % of a core at "
+              << SpectrumAnalyser::refreshRateHz << " fps\n";
+}
+
+TEST_CASE ("Response curve")
+{
+    // Dragging one knob with 50 editors open, in the software renderer: each
+    // display recomputes the band that moved and repaints only where its
+    // curve moved, against redrawing every layer of every display
+    constexpr int numEditors = 50;
+
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, 512);
+    plugin.apvts.getParameter ("midQ")->setValueNotifyingHost (plugin.apvts.getParameter ("midQ")->convertTo0to1 (2.0f));
+
+    std::vector<std::unique_ptr<ResponseCurveDisplay>> displays;
+    for (int i = 0; i < numEditors; ++i)
+    {
+        displays.push_back (std::make_unique<ResponseCurveDisplay> (plugin));
+        displays.back()->setSize (680, 140);
+    }
+
+    juce::Image screen (juce::Image::RGB, 680, 140, true);
+    auto* gain = plugin.apvts.getParameter ("midGain");
+    int step = 0;
+
+    auto drag = [&] { gain->setValueNotifyingHost (0.5f + 0.25f * std::sin (0.05f * (float) ++step)); };
+
+    BENCHMARK ("Idle tick, 50 displays")
+    {
+        int changed = 0;
+        for (auto& display : displays)
+            changed += display->refresh().isEmpty() ? 0 : 1;
+        return changed;
+    };
+
+    BENCHMARK ("Knob step, 50 displays, dirty region only")
+    {
+        drag();
+        int pixels = 0;
+        for (auto& display : displays)
+        {
+            const auto dirty = display->refresh();
+            juce::Graphics g (screen);
+            g.reduceClipRegion (dirty);
+            display->paintEntireComponent (g, false);
+            pixels += dirty.getWidth() * dirty.getHeight();
+        }
+        return pixels;
+    };
+
+    BENCHMARK ("Knob step, 50 displays, everything redrawn")
+    {
+        drag();
+        for (auto& display : displays)
+        {
+            display->resized();
+            juce::Graphics g (screen);
+            display->paintEntireComponent (g, false);
+        }
+        return screen.getPixelAt (340, 70).getARGB();
+    };
+}
+
+TEST_CASE ("Telemetry")
+{
+    // What the instrumentation costs, and what it reports from inside
+    // processBlock for an ordinary stereo block with a knob moving
+    constexpr int blockSize = 512;
+
+    Telemetry telemetry;
+
+    BENCHMARK ("Telemetry::ScopedTimer")
+    {
+        const Telemetry::ScopedTimer timer (telemetry, Telemetry::Filters);
+        return 0;
+    };
+
+    BENCHMARK ("Telemetry::snapshot")
+    {
+        return telemetry.snapshot().count[Telemetry::Filters];
+    };
+
+    PluginProcessor plugin;
+    plugin.prepareToPlay (48000.0, blockSize);
+
+    juce::Random random (23);
+    juce::AudioBuffer<float> buffer (2, blockSize);
+    juce::MidiBuffer midi;
+    auto* gain = plugin.apvts.getParameter ("midGain");
+
+    const auto before = plugin.getTelemetry();
+    for (int block = 0; block < 2000; ++block)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample (ch, i, random.nextFloat() - 0.5f);
+
+        if (block % 10 == 0)
+            gain->setValueNotifyingHost (random.nextFloat());
+
+        plugin.processBlock (buffer, midi);
+    }
+    const auto after = plugin.getTelemetry();
+
+    if constexpr (Telemetry::enabled)
+    {
+        const auto audioSeconds = (double) (after.samples - before.samples) / 48000.0;
+
+        std::cout << "processBlock (stereo, 512): load " << after.loadSince (before, 48000.0) * 100.0 << " %, "
+                  << "p50 " << after.percentileNanos (Telemetry::Block, 0.5, before) * 1.0e-3 << " us, "
+                  << "p99 " << after.percentileNanos (Telemetry::Block, 0.99, before) * 1.0e-3 << " us, "
+                  << "worst " << (double) after.worstNanos[Telemetry::Block] * 1.0e-3 << " us, "
+                  << "gain loop p99 " << after.percentileNanos (Telemetry::GainLoop, 0.99, before) * 1.0e-3 << " us, "
+                  << (double) (after.coefficientDesigns - before.coefficientDesigns) / audioSeconds << " coefficient designs per second of audio\n";
+    }
+}
+
+TEST_CASE ("Sidechain ducking")
+{
+    // Master ducking should be one scan of the key and a gain ramp on top of
+    // the EQ; a ducked band runs the EQ 32 samples at a time
+    constexpr int blockSize = 512;
+
+    juce::MidiBuffer midi;
+    juce::Random random (11);
+
+    // Main input on channels 0-1, the key on 2-3, as a host lays them out
+    juce::AudioBuffer<float> input (4, blockSize), buffer (4, blockSize);
+    for (int ch = 0; ch < 4; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            input.setSample (ch, i, random.nextFloat() - 0.5f);
+
+    for (const auto [target, name] : { std::pair { PluginProcessor::duckTargetOff, "processBlock, sidechain, not ducking (stereo, 512)" },
+                                       std::pair { PluginProcessor::duckTargetMaster, "processBlock, ducking master (stereo, 512)" },
+                                       std::pair { PluginProcessor::duckTargetBand (0), "processBlock, ducking a band (stereo, 512)" } })
+    {
+        PluginProcessor plugin;
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (juce::AudioChannelSet::stereo());
+        layout.inputBuses.add (juce::AudioChannelSet::stereo());
+        layout.outputBuses.add (juce::AudioChannelSet::stereo());
+        plugin.setBusesLayout (layout);
+
+        auto* param = plugin.apvts.getParameter ("duckTarget");
+        param->setValueNotifyingHost (param->convertTo0to1 ((float) target));
+        plugin.prepareToPlay (48000.0, blockSize);
+
+        BENCHMARK (name)
+        {
+            buffer.makeCopyOf (input, true);
+            plugin.processBlock (buffer, midi);
+            return buffer.getSample (0, blockSize - 1);
+        };
+    }
+}
@@ -19,5 +19,9 @@ int main (int argc, char* argv[])
 #include "PluginEditor.h"
 #include "catch2/benchmark/catch_benchmark_all.hpp"
 #include "catch2/catch_test_macros.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
 
 #include "Benchmarks.cpp"
@@ -0,0 +1,269 @@
+// Batch renderer: streams audio files through MojoPunch without a host.
+//
+//   Render [options] file...
+//
+//     --state <file>      a state saved by the plugin (binary, or XML from older versions)
+//     --set <id>=<value>  a parameter in its own units, after any state; repeatable
+//     --out <dir>         where rendered files go (default: next to each input)
+//     --format wav|flac   output format (default: the input's, WAV for anything else)
+//     --jobs <n>          files rendered at once (default: one per core)
+//     --block <n>         samples per processBlock (default: 8192)
+//
+// Each worker thread owns one processor and takes the next file until
+// none are left. Rendered files are named <input>.mojopunch.<ext>.
+
+#include "OfflineRender.h"
+#include "PluginProcessor.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        juce::MemoryBlock state;
+        std::vector<std::pair<juce::String, float>> parameters;
+        juce::File outputDirectory;
+        juce::String format;
+        int jobs = juce::jmax (1, (int) std::thread::hardware_concurrency());
+        int blockSize = 8192;
+        juce::Array<juce::File> inputs;
+    };
+
+    int usage (const juce::String& error)
+    {
+        std::cerr << error << "\n\n"
+                  << "Render [--state file] [--set id=value]... [--out dir] [--format wav|flac]\n"
+                  << "       [--jobs n] [--block n] file...\n";
+        return 1;
+    }
+
+    std::optional<juce::String> parseArguments (int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const juce::String arg (argv[i]);
+            auto next = [&]() -> std::optional<juce::String> {
+                if (i + 1 >= argc)
+                    return std::nullopt;
+                return juce::String (argv[++i]);
+            };
+
+            if (arg.startsWith ("--"))
+            {
+                const auto value = next();
+                if (! value)
+                    return arg + " needs a value";
+
+                if (arg == "--state")
+                {
+                    const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (*value);
+                    if (! file.loadFileAsData (options.state))
+                        return "Can't read " + file.getFullPathName();
+                }
+                else if (arg == "--set")
+                {
+                    if (! value->containsChar ('='))
+                        return "--set takes id=value";
+                    options.parameters.emplace_back (value->upToFirstOccurrenceOf ("=", false, false),
+                                                     value->fromFirstOccurrenceOf ("=", false, false).getFloatValue());
+                }
+                else if (arg == "--out")
+                {
+                    options.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile (*value);
+                    if (! options.outputDirectory.createDirectory())
+                        return "Can't create " + options.outputDirectory.getFullPathName();
+                }
+                else if (arg == "--format")
+                {
+                    options.format = value->toLowerCase();
+                    if (options.format != "wav" && options.format != "flac")
+                        return "Unknown format " + *value;
+                }
+                else if (arg == "--jobs")
+                {
+                    options.jobs = juce::jmax (1, value->getIntValue());
+                }
+                else if (arg == "--block")
+                {
+                    options.blockSize = value->getIntValue();
+                    if (options.blockSize < 1)
+                        return "Block size must be at least 1";
+                }
+                else
+                {
+                    return "Unknown option " + arg;
+                }
+            }
+            else
+            {
+                const auto file = juce::File::getCurrentWorkingDirectory().getChildFile (arg);
+                if (! file.existsAsFile())
+                    return "No such file " + file.getFullPathName();
+                options.inputs.add (file);
+            }
+        }
+
+        if (options.inputs.isEmpty())
+            return juce::String ("No input files");
+
+        return std::nullopt;
+    }
+
+    // Everything from the command line, checked before any work starts
+    bool applySettings (PluginProcessor& processor, const Options& options, juce::String& error)
+    {
+        if (! options.state.isEmpty())
+            processor.setStateInformation (options.state.getData(), (int) options.state.getSize());
+
+        for (const auto& [id, value] : options.parameters)
+        {
+            auto* param = processor.apvts.getParameter (id);
+            if (param == nullptr)
+            {
+                error = "Unknown parameter " + id;
+                return false;
+            }
+            param->setValueNotifyingHost (param->convertTo0to1 (value));
+        }
+
+        return true;
+    }
+
+    struct Job
+    {
+        juce::File input;
+        double audioSeconds {}, wallSeconds {};
+        juce::String error;
+    };
+
+    void renderFile (PluginProcessor& processor, juce::AudioFormatManager& formats, const Options& options, Job& job)
+    {
+        const auto started = std::chrono::steady_clock::now();
+
+        std::unique_ptr<juce::AudioFormatReader> reader (formats.createReaderFor (job.input));
+        if (reader == nullptr)
+        {
+            job.error = "not an audio file this build can read";
+            return;
+        }
+
+        if (! OfflineRender::setChannels (processor, (int) reader->numChannels))
+        {
+            job.error = juce::String (reader->numChannels) + " channels aren't supported";
+            return;
+        }
+
+        // The input's format when it is one we write, otherwise WAV. FLAC
+        // stops at 24 bits, so float sources become 24-bit there.
+        auto formatName = options.format;
+        if (formatName.isEmpty())
+            formatName = job.input.hasFileExtension ("flac") ? "flac" : "wav";
+
+        auto* format = formatName == "flac" ? formats.findFormatForFileExtension ("flac")
+                                            : formats.findFormatForFileExtension ("wav");
+        auto bits = reader->usesFloatingPointData ? 32 : (int) reader->bitsPerSample;
+        if (formatName == "flac")
+            bits = juce::jmin (bits, 24);
+
+        const auto directory = options.outputDirectory == juce::File() ? job.input.getParentDirectory() : options.outputDirectory;
+        const auto output    = directory.getChildFile (job.input.getFileNameWithoutExtension() + ".mojopunch." + formatName);
+        output.deleteFile();
+
+        auto stream = std::make_unique<juce::FileOutputStream> (output);
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        if (format != nullptr && stream->openedOk())
+            writer.reset (format->createWriterFor (stream.get(), reader->sampleRate, reader->numChannels, bits, reader->metadataValues, 0));
+
+        if (writer == nullptr)
+        {
+            job.error = "can't write " + output.getFullPathName();
+            return;
+        }
+
+        stream.release(); // the writer owns it now
+
+        if (! OfflineRender::render (processor, *reader, *writer, options.blockSize))
+            job.error = "write failed on " + output.getFullPathName();
+
+        job.audioSeconds = (double) reader->lengthInSamples / reader->sampleRate;
+        job.wallSeconds  = std::chrono::duration<double> (std::chrono::steady_clock::now() - started).count();
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI gui;
+
+    Options options;
+    if (auto error = parseArguments (argc, argv, options))
+        return usage (*error);
+
+    const int numWorkers = juce::jmin (options.jobs, options.inputs.size());
+
+    // Processors are made here, on the message thread, then each worker
+    // keeps its own for every file it takes
+    std::vector<std::unique_ptr<PluginProcessor>> processors;
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto processor = std::make_unique<PluginProcessor>();
+        juce::String error;
+        if (! applySettings (*processor, options, error))
+            return usage (error);
+        processors.push_back (std::move (processor));
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::vector<Job> jobs ((size_t) options.inputs.size());
+    for (size_t i = 0; i < jobs.size(); ++i)
+        jobs[i].input = options.inputs[(int) i];
+
+    std::atomic<size_t> nextJob { 0 };
+    std::mutex printLock;
+
+    auto work = [&] (PluginProcessor& processor) {
+        for (auto index = nextJob++; index < jobs.size(); index = nextJob++)
+        {
+            auto& job = jobs[index];
+            renderFile (processor, formats, options, job);
+
+            const std::scoped_lock lock (printLock);
+            if (job.error.isNotEmpty())
+                std::cerr << job.input.getFileName() << ": " << job.error << "\n";
+            else
+                std::cout << job.input.getFileName() << ": " << job.audioSeconds << " s in " << job.wallSeconds << " s, "
+                          << job.audioSeconds / job.wallSeconds << "x real-time\n";
+        }
+    };
+
+    const auto started = std::chrono::steady_clock::now();
+    {
+        std::vector<std::thread> workers;
+        for (auto& processor : processors)
+            workers.emplace_back (work, std::ref (*processor));
+        for (auto& worker : workers)
+            worker.join();
+    }
+    const auto wallSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - started).count();
+
+    double audioSeconds = 0.0;
+    int failed = 0;
+    for (const auto& job : jobs)
+    {
+        audioSeconds += job.audioSeconds;
+        failed += job.error.isNotEmpty() ? 1 : 0;
+    }
+
+    std::cout << jobs.size() - (size_t) failed << " files, " << audioSeconds << " s of audio in " << wallSeconds << " s on "
+              << numWorkers << " threads: " << audioSeconds / wallSeconds << "x real-time, "
+              << audioSeconds / wallSeconds / numWorkers << "x per thread\n";
+
+    return failed == 0 ? 0 : 2;
+}
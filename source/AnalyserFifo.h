@@ -0,0 +1,96 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Wait-free single-producer/single-consumer ring of mono samples, carrying
+    audio from processBlock to the editor's analyser.
+
+    push() mixes the block's channels down straight into the ring: one
+    vectorised copy and one multiply-add per channel, nothing else. When the
+    reader has fallen behind the samples that don't fit are dropped, so the
+    audio thread never waits and never overwrites what the reader is
+    copying out.
+
+    prepare() allocates and is for the message thread, before the audio
+    thread is allowed to push.
+*/
+class AnalyserFifo
+{
+public:
+    void prepare (int capacity)
+    {
+        buffer.assign ((size_t) capacity, 0.0f);
+        fifo.setTotalSize (capacity);
+    }
+
+    bool isPrepared() const noexcept { return ! buffer.empty(); }
+
+    /** Audio thread. Returns the number of samples that fitted. */
+    template <typename SampleType>
+    int push (const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (numChannels <= 0)
+            return 0;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+        const auto scale = SampleType (1) / (SampleType) numChannels;
+        mixDown (buffer.data() + start1, channels, numChannels, 0, size1, scale);
+        mixDown (buffer.data() + start2, channels, numChannels, size1, size2, scale);
+
+        fifo.finishedWrite (size1 + size2);
+        return size1 + size2;
+    }
+
+    /** Reader side. Copies out up to maxSamples, oldest first. */
+    int pop (float* dest, int maxSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (maxSamples, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            juce::FloatVectorOperations::copy (dest, buffer.data() + start1, size1);
+        if (size2 > 0)
+            juce::FloatVectorOperations::copy (dest + size1, buffer.data() + start2, size2);
+
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+    /** Reader side. */
+    void clear() noexcept { fifo.finishedRead (fifo.getNumReady()); }
+
+private:
+    static void mixDown (float* dest, const float* const* channels, int numChannels, int offset, int num, float scale) noexcept
+    {
+        if (num <= 0)
+            return;
+
+        juce::FloatVectorOperations::copyWithMultiply (dest, channels[0] + offset, scale, num);
+        for (int ch = 1; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::addWithMultiply (dest, channels[ch] + offset, scale, num);
+    }
+
+    // The analyser only ever draws in float
+    static void mixDown (float* dest, const double* const* channels, int numChannels, int offset, int num, double scale) noexcept
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            double sum = 0.0;
+            for (int ch = 0; ch < numChannels; ++ch)
+                sum += channels[ch][offset + i];
+            dest[i] = (float) (sum * scale);
+        }
+    }
+
+    juce::AbstractFifo fifo { 1 };
+    std::vector<float> buffer;
+
+    JUCE_DECLARE_NON_COPYABLE (AnalyserFifo)
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "dsp/FilterDesign.h"
+#include <array>
+
+// Which band table the plugin is built with; set from CMake
+#ifndef MOJOPUNCH_NUM_BANDS
+ #define MOJOPUNCH_NUM_BANDS 3
+#endif
+
+//==============================================================================
+/** One EQ band as the plugin exposes it. Everything per band (parameters,
+    cached atomics, the EQ chains and the editor columns) is generated from a
+    table of these.
+*/
+struct BandSpec
+{
+    BandType type;
+    const char* id;     // Parameter ID prefix: "low" gives "lowFreq", "lowGain", ...
+    const char* name;   // Parameter name prefix
+    const char* title;  // Editor column heading
+    float minFreq, maxFreq, defaultFreq, defaultQ;
+};
+
+namespace BandLayout
+{
+   #if MOJOPUNCH_NUM_BANDS == 3
+    inline constexpr std::array<BandSpec, 3> bands { {
+        { BandType::LowShelf,  "low",  "Low",  "Low Shelf",  20.0f,   800.0f,   200.0f,  0.707f },
+        { BandType::PeakBell,  "mid",  "Mid",  "Mid Bell",   200.0f,  8000.0f,  1000.0f, 1.0f },
+        { BandType::HighShelf, "high", "High", "High Shelf", 1000.0f, 20000.0f, 8000.0f, 0.707f } } };
+   #elif MOJOPUNCH_NUM_BANDS == 5
+    inline constexpr std::array<BandSpec, 5> bands { {
+        { BandType::LowShelf,  "low",     "Low",      "Low Shelf",  20.0f,   800.0f,   100.0f,  0.707f },
+        { BandType::PeakBell,  "lowMid",  "Low Mid",  "Low Mid",    40.0f,   2000.0f,  300.0f,  1.0f },
+        { BandType::PeakBell,  "mid",     "Mid",      "Mid Bell",   200.0f,  8000.0f,  1000.0f, 1.0f },
+        { BandType::PeakBell,  "highMid", "High Mid", "High Mid",   800.0f,  16000.0f, 3500.0f, 1.0f },
+        { BandType::HighShelf, "high",    "High",     "High Shelf", 1000.0f, 20000.0f, 10000.0f, 0.707f } } };
+   #elif MOJOPUNCH_NUM_BANDS == 8
+    inline constexpr std::array<BandSpec, 8> bands { {
+        { BandType::LowShelf,  "low",   "Low",    "Low Shelf",  20.0f,   800.0f,   80.0f,    0.707f },
+        { BandType::PeakBell,  "band2", "Band 2", "Band 2",     20.0f,   1000.0f,  150.0f,   1.0f },
+        { BandType::PeakBell,  "band3", "Band 3", "Band 3",     40.0f,   2000.0f,  300.0f,   1.0f },
+        { BandType::PeakBell,  "band4", "Band 4", "Band 4",     100.0f,  5000.0f,  700.0f,   1.0f },
+        { BandType::PeakBell,  "band5", "Band 5", "Band 5",     200.0f,  8000.0f,  1500.0f,  1.0f },
+        { BandType::PeakBell,  "band6", "Band 6", "Band 6",     500.0f,  16000.0f, 3000.0f,  1.0f },
+        { BandType::PeakBell,  "band7", "Band 7", "Band 7",     1000.0f, 20000.0f, 6000.0f,  1.0f },
+        { BandType::HighShelf, "high",  "High",   "High Shelf", 1000.0f, 20000.0f, 12000.0f, 0.707f } } };
+   #else
+    #error "MOJOPUNCH_NUM_BANDS must be 3, 5 or 8"
+   #endif
+
+    inline constexpr int numBands = (int) bands.size();
+
+    /** The band shapes alone, in the form the EQ engines take them. */
+    inline constexpr auto types = [] {
+        std::array<BandType, bands.size()> t {};
+        for (size_t i = 0; i < bands.size(); ++i)
+            t[i] = bands[i].type;
+        return t;
+    }();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+
+//==============================================================================
+/**
+    Streams an audio file through a processor as a host does for an offline
+    bounce: non-realtime, in fixed blocks, and with the processor's latency
+    taken back out, so the output lines up with the input and is the same
+    length. The render target uses it, one processor per worker thread.
+*/
+namespace OfflineRender
+{
+    /** The bus layout for a file with numChannels channels. Returns false if
+        the processor can't take that many.
+    */
+    inline bool setChannels (juce::AudioProcessor& processor, int numChannels)
+    {
+        const auto set = juce::AudioChannelSet::canonicalChannelSet (numChannels);
+        if (set.isDisabled())
+            return false;
+
+        // Only the main buses change; a sidechain stays as it was
+        auto layout = processor.getBusesLayout();
+        if (layout.inputBuses.isEmpty() || layout.outputBuses.isEmpty())
+            return false;
+
+        layout.inputBuses.getReference (0)  = set;
+        layout.outputBuses.getReference (0) = set;
+        return processor.setBusesLayout (layout);
+    }
+
+    /** Prepares processor for the reader's rate and runs the whole file
+        through it into writer, blockSize samples at a time. The processor's
+        bus layout must already match the reader's channels. Returns false if
+        the writer fails.
+    */
+    inline bool render (juce::AudioProcessor& processor, juce::AudioFormatReader& reader, juce::AudioFormatWriter& writer, int blockSize)
+    {
+        const int numChannels = (int) reader.numChannels;
+        const auto length     = reader.lengthInSamples;
+
+        processor.setNonRealtime (true);
+        processor.prepareToPlay (reader.sampleRate, blockSize);
+
+        // Room for any sidechain too, which hears silence
+        juce::AudioBuffer<float> buffer (juce::jmax (numChannels, processor.getTotalNumInputChannels()), blockSize);
+        juce::MidiBuffer midi;
+
+        // Past the end of the file the processor gets silence, until the
+        // latency it held back has come out too
+        juce::int64 readPosition = 0, written = 0;
+        auto latencyLeft = (juce::int64) processor.getLatencySamples();
+        bool ok = true;
+
+        while (ok && written < length)
+        {
+            buffer.clear();
+
+            const auto fromFile = (int) juce::jlimit<juce::int64> (0, blockSize, length - readPosition);
+            if (fromFile > 0)
+                reader.read (&buffer, 0, fromFile, readPosition, true, true);
+
+            readPosition += blockSize;
+            processor.processBlock (buffer, midi);
+
+            const auto skipped = (int) juce::jmin<juce::int64> (latencyLeft, blockSize);
+            const auto toWrite = (int) juce::jmin<juce::int64> (blockSize - skipped, length - written);
+            latencyLeft -= skipped;
+
+            if (toWrite > 0)
+                ok = writer.writeFromAudioSampleBuffer (buffer, skipped, toWrite);
+
+            written += toWrite;
+        }
+
+        processor.releaseResources();
+        return ok;
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/** A single host parameter change, timestamped within the current block. */
+struct ParameterEvent
+{
+    int parameterIndex {};      // PluginProcessor::ParameterIndex
+    int sampleOffset {};        // position within the block the change lands on
+    float normalisedValue {};   // 0..1, as the host sends it
+};
+
+//==============================================================================
+/**
+    Lock-free single-producer/single-consumer FIFO of parameter events.
+
+    The host-event callback pushes, processBlock pops and splits the buffer at
+    each event's offset. Storage is allocated once in the constructor, so both
+    ends are safe to call on the audio thread.
+
+    Events are expected in ascending sampleOffset order (CLAP guarantees this
+    for a block's input events).
+*/
+class ParameterEventQueue
+{
+public:
+    explicit ParameterEventQueue (int capacity = 1024)
+        : fifo (capacity), events ((size_t) capacity)
+    {
+    }
+
+    /** Returns false (and drops the event) when the queue is full. */
+    bool push (const ParameterEvent& event) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        events[(size_t) (size1 > 0 ? start1 : start2)] = event;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    /** Reads the oldest event without removing it. */
+    bool peek (ParameterEvent& event) const noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        event = events[(size_t) (size1 > 0 ? start1 : start2)];
+        return true;
+    }
+
+    /** Removes the oldest event. */
+    void pop() noexcept
+    {
+        if (fifo.getNumReady() > 0)
+            fifo.finishedRead (1);
+    }
+
+    /** Offset of the oldest pending event, or limit if there is none before it. */
+    int nextOffset (int limit) const noexcept
+    {
+        ParameterEvent event;
+        return peek (event) ? juce::jmin (event.sampleOffset, limit) : limit;
+    }
+
+    bool isEmpty() const noexcept { return fifo.getNumReady() == 0; }
+
+    /** Consumer side only. */
+    void clear() noexcept { fifo.finishedRead (fifo.getNumReady()); }
+
+private:
+    juce::AbstractFifo fifo;
+    std::vector<ParameterEvent> events;
+
+    JUCE_DECLARE_NON_COPYABLE (ParameterEventQueue)
+};
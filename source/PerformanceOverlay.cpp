@@ -0,0 +1,52 @@
+#include "PerformanceOverlay.h"
+
+PerformanceOverlay::PerformanceOverlay (PluginProcessor& p)
+    : processorRef (p)
+{
+    setInterceptsMouseClicks (false, false);
+
+    if constexpr (Telemetry::enabled)
+    {
+        previous        = processorRef.getTelemetry();
+        previousSeconds = juce::Time::getMillisecondCounterHiRes() * 1.0e-3;
+        startTimerHz (refreshRateHz);
+    }
+}
+
+void PerformanceOverlay::timerCallback()
+{
+    const auto current = processorRef.getTelemetry();
+    const auto seconds = juce::Time::getMillisecondCounterHiRes() * 1.0e-3;
+    const auto sampleRate = processorRef.getSampleRate();
+
+    juce::String newText;
+
+    // Nothing processed since last time: the host has stopped calling us
+    if (current.count[Telemetry::Block] != previous.count[Telemetry::Block] && sampleRate > 0.0)
+    {
+        const auto load    = current.loadSince (previous, sampleRate);
+        const auto p99     = current.percentileNanos (Telemetry::Block, 0.99, previous);
+        const auto designs = (double) (current.coefficientDesigns - previous.coefficientDesigns) / (seconds - previousSeconds);
+
+        newText << "CPU " << juce::String (load * 100.0, 1) << "%  "
+                << "p99 " << juce::roundToInt (p99 * 1.0e-3) << "us  "
+                << "worst " << juce::roundToInt ((double) current.worstNanos[Telemetry::Block] * 1.0e-3) << "us  "
+                << juce::roundToInt (designs) << " designs/s";
+    }
+
+    previous        = current;
+    previousSeconds = seconds;
+
+    if (newText != text)
+    {
+        text = newText;
+        repaint();
+    }
+}
+
+void PerformanceOverlay::paint (juce::Graphics& g)
+{
+    g.setColour (juce::Colours::white.withAlpha (0.55f));
+    g.setFont (11.0f);
+    g.drawText (text, getLocalBounds(), juce::Justification::centredRight, false);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "PluginProcessor.h"
+
+//==============================================================================
+/**
+    One line of audio-thread load in the corner of the editor: the share of
+    real time processBlock took, its 99th-percentile and worst block times,
+    and coefficient designs a second, all over the last second or so.
+
+    It reads the processor's telemetry snapshots on a slow timer and draws
+    nothing when telemetry is compiled out.
+*/
+class PerformanceOverlay : public juce::Component,
+                           private juce::Timer
+{
+public:
+    static constexpr int refreshRateHz = 4;
+
+    explicit PerformanceOverlay (PluginProcessor&);
+
+    void paint (juce::Graphics&) override;
+
+private:
+    PluginProcessor& processorRef;
+    Telemetry::Snapshot previous;
+    double previousSeconds {};
+    juce::String text;
+
+    void timerCallback() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceOverlay)
+};
@@ -1,5 +1,13 @@
 #include "PluginEditor.h"
 
+template <typename Attachment, typename Control>
+std::unique_ptr<Attachment> PluginEditor::attach (const juce::String& paramID, Control& control)
+{
+    auto attachment = std::make_unique<Attachment> (*processorRef.apvts.getParameter (paramID), control);
+    attachment->sendInitialUpdate();
+    return attachment;
+}
+
 void PluginEditor::configureRotary (juce::Slider& slider, juce::Label& label, const juce::String& text)
 {
     slider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
@@ -12,33 +20,89 @@ void PluginEditor::configureRotary (juce::Slider& slider, juce::Label& label, co
     addAndMakeVisible (label);
 }
 
+void PluginEditor::attachBandControls (int set)
+{
+    using BandParameter = PluginProcessor::BandParameter;
+
+    for (int band = 0; band < PluginProcessor::numBands; ++band)
+    {
+        auto& c = bandControls[(size_t) band];
+        auto id = [band, set] (BandParameter param) { return PluginProcessor::getParameterID (PluginProcessor::bandParameterIndex (band, param, set)); };
+
+        // Let go of the old set before attaching, so only one parameter ever drives a control
+        c.freqAttach.reset();
+        c.gainAttach.reset();
+        c.qAttach.reset();
+        c.thresholdAttach.reset();
+        c.ratioAttach.reset();
+        c.dynamicAttach.reset();
+
+        c.freqAttach      = attach<SliderAttachment> (id (BandParameter::Freq),      c.freq);
+        c.gainAttach      = attach<SliderAttachment> (id (BandParameter::Gain),      c.gain);
+        c.qAttach         = attach<SliderAttachment> (id (BandParameter::Q),         c.q);
+        c.thresholdAttach = attach<SliderAttachment> (id (BandParameter::Threshold), c.threshold);
+        c.ratioAttach     = attach<SliderAttachment> (id (BandParameter::Ratio),     c.ratio);
+        c.dynamicAttach   = attach<ButtonAttachment> (id (BandParameter::Dynamic),   c.dynamic);
+    }
+}
+
 //==============================================================================
 PluginEditor::PluginEditor (PluginProcessor& p)
     : AudioProcessorEditor (&p), processorRef (p)
 {
-    auto& apvts = processorRef.apvts;
-
-    configureRotary (lowFreqSlider,    lowFreqLabel,    "Freq");
-    configureRotary (lowGainSlider,    lowGainLabel,    "Gain");
-    configureRotary (lowQSlider,       lowQLabel,       "Q");
-    configureRotary (midFreqSlider,    midFreqLabel,    "Freq");
-    configureRotary (midGainSlider,    midGainLabel,    "Gain");
-    configureRotary (midQSlider,       midQLabel,       "Q");
-    configureRotary (highFreqSlider,   highFreqLabel,   "Freq");
-    configureRotary (highGainSlider,   highGainLabel,   "Gain");
-    configureRotary (highQSlider,      highQLabel,      "Q");
+    for (auto& c : bandControls)
+    {
+        configureRotary (c.freq,      c.freqLabel,      "Freq");
+        configureRotary (c.gain,      c.gainLabel,      "Gain");
+        configureRotary (c.q,         c.qLabel,         "Q");
+        configureRotary (c.threshold, c.thresholdLabel, "Thresh");
+        configureRotary (c.ratio,     c.ratioLabel,     "Ratio");
+        addAndMakeVisible (c.dynamic);
+    }
+
+    attachBandControls (0);
+
     configureRotary (masterGainSlider, masterGainLabel, "Master");
+    configureRotary (attackSlider,     attackLabel,     "Attack");
+    configureRotary (sustainSlider,    sustainLabel,    "Sustain");
+    configureRotary (duckThresholdSlider, duckThresholdLabel, "Thresh");
+    configureRotary (duckRangeSlider,     duckRangeLabel,     "Range");
+
+    masterGainAttach = attach<SliderAttachment> ("masterGain", masterGainSlider);
+    attackAttach     = attach<SliderAttachment> ("attack",     attackSlider);
+    sustainAttach    = attach<SliderAttachment> ("sustain",    sustainSlider);
+    duckThresholdAttach = attach<SliderAttachment> ("duckThreshold", duckThresholdSlider);
+    duckRangeAttach     = attach<SliderAttachment> ("duckRange",     duckRangeSlider);
 
-    lowFreqAttach    = std::make_unique<SliderAttachment> (apvts, "lowFreq",    lowFreqSlider);
-    lowGainAttach    = std::make_unique<SliderAttachment> (apvts, "lowGain",    lowGainSlider);
-    lowQAttach       = std::make_unique<SliderAttachment> (apvts, "lowQ",       lowQSlider);
-    midFreqAttach    = std::make_unique<SliderAttachment> (apvts, "midFreq",    midFreqSlider);
-    midGainAttach    = std::make_unique<SliderAttachment> (apvts, "midGain",    midGainSlider);
-    midQAttach       = std::make_unique<SliderAttachment> (apvts, "midQ",       midQSlider);
-    highFreqAttach   = std::make_unique<SliderAttachment> (apvts, "highFreq",   highFreqSlider);
-    highGainAttach   = std::make_unique<SliderAttachment> (apvts, "highGain",   highGainSlider);
-    highQAttach      = std::make_unique<SliderAttachment> (apvts, "highQ",      highQSlider);
-    masterGainAttach = std::make_unique<SliderAttachment> (apvts, "masterGain", masterGainSlider);
+    // Choice boxes take their items from the parameters, so fill them before attaching
+    for (auto [box, paramID] : { std::pair { &oversamplingBox, "oversampling" },
+                                 std::pair { &oversamplingFilterBox, "oversamplingFilter" },
+                                 std::pair { &phaseModeBox, "phaseMode" },
+                                 std::pair { &stereoModeBox, "stereoMode" },
+                                 std::pair { &duckTargetBox, "duckTarget" } })
+    {
+        box->addItemList (processorRef.apvts.getParameter (paramID)->getAllValueStrings(), 1);
+        addAndMakeVisible (*box);
+    }
+
+    oversamplingAttach       = attach<ComboBoxAttachment> ("oversampling",       oversamplingBox);
+    oversamplingFilterAttach = attach<ComboBoxAttachment> ("oversamplingFilter", oversamplingFilterBox);
+    phaseModeAttach          = attach<ComboBoxAttachment> ("phaseMode",          phaseModeBox);
+    stereoModeAttach         = attach<ComboBoxAttachment> ("stereoMode",         stereoModeBox);
+    duckTargetAttach         = attach<ComboBoxAttachment> ("duckTarget",         duckTargetBox);
+
+    // Set A is all there is when linked; B only matters in the split modes
+    bandSetBox.addItemList ({ "A: Mid / Left", "B: Side / Right" }, 1);
+    bandSetBox.setSelectedId (1, juce::dontSendNotification);
+    bandSetBox.onChange = [this] {
+        attachBandControls (bandSetBox.getSelectedItemIndex());
+        responseCurve.setChannelSet (bandSetBox.getSelectedItemIndex());
+    };
+    addAndMakeVisible (bandSetBox);
+
+    addAndMakeVisible (responseCurve);
+    addAndMakeVisible (analyser);
+    addAndMakeVisible (performance);
 
     addAndMakeVisible (inspectButton);
     inspectButton.onClick = [&] {
@@ -50,7 +114,14 @@ PluginEditor::PluginEditor (PluginProcessor& p)
         inspector->setVisible (true);
     };
 
-    setSize (720, 380);
+    // One 160 px column per band, then the master column and its overhang,
+    // then the sidechain column; the response curve and analyser strips
+    // under them
+    setOpaque (true);
+    setSize (40 + PluginProcessor::numBands * 160 + 300, 800);
+
+    hostChangesShown = processorRef.getHostChangeCount();
+    startTimerHz (30);
 }
 
 PluginEditor::~PluginEditor()
@@ -58,6 +129,52 @@ PluginEditor::~PluginEditor()
 }
 
 void PluginEditor::paint (juce::Graphics& g)
+{
+    // At the pixel size of whatever this is painted to, so it stays sharp on
+    // high-density screens and under host zoom
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (background.isNull() || scale != backgroundScale)
+    {
+        backgroundScale = scale;
+        background = juce::Image (juce::Image::RGB,
+                                  juce::jmax (1, juce::roundToInt ((float) getWidth() * scale)),
+                                  juce::jmax (1, juce::roundToInt ((float) getHeight() * scale)),
+                                  false);
+
+        juce::Graphics bg (background);
+        bg.addTransform (juce::AffineTransform::scale (scale));
+        drawBackground (bg);
+    }
+
+    g.drawImageTransformed (background, juce::AffineTransform::scale (1.0f / backgroundScale));
+}
+
+void PluginEditor::timerCallback()
+{
+    // Host automation has moved something. Cheaper to re-read every control
+    // than to work out which.
+    const auto changes = processorRef.getHostChangeCount();
+    if (changes == hostChangesShown)
+        return;
+
+    hostChangesShown = changes;
+
+    for (auto& c : bandControls)
+    {
+        for (auto* attachment : { c.freqAttach.get(), c.gainAttach.get(), c.qAttach.get(), c.thresholdAttach.get(), c.ratioAttach.get() })
+            attachment->sendInitialUpdate();
+
+        c.dynamicAttach->sendInitialUpdate();
+    }
+
+    for (auto* attachment : { masterGainAttach.get(), attackAttach.get(), sustainAttach.get(), duckThresholdAttach.get(), duckRangeAttach.get() })
+        attachment->sendInitialUpdate();
+
+    for (auto* attachment : { oversamplingAttach.get(), oversamplingFilterAttach.get(), phaseModeAttach.get(), stereoModeAttach.get(), duckTargetAttach.get() })
+        attachment->sendInitialUpdate();
+}
+
+void PluginEditor::drawBackground (juce::Graphics& g)
 {
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 
@@ -70,15 +187,18 @@ void PluginEditor::paint (juce::Graphics& g)
     // Band labels at the top of each EQ column
     const int colW = 160;
     const int startX = 40;
-    g.drawText ("Low Shelf",  startX,            8, colW, 24, juce::Justification::centred, true);
-    g.drawText ("Mid Bell",   startX + colW,     8, colW, 24, juce::Justification::centred, true);
-    g.drawText ("High Shelf", startX + colW * 2, 8, colW, 24, juce::Justification::centred, true);
-    g.drawText ("Master",     startX + colW * 3, 8,  80, 24, juce::Justification::centred, true);
+    for (int band = 0; band < PluginProcessor::numBands; ++band)
+        g.drawText (BandLayout::bands[(size_t) band].title, startX + colW * band, 8, colW, 24, juce::Justification::centred, true);
+
+    g.drawText ("Master", startX + colW * PluginProcessor::numBands, 8, 80, 24, juce::Justification::centred, true);
+    g.drawText ("Duck", startX + colW * PluginProcessor::numBands + 200, 8, 90, 24, juce::Justification::centred, true);
 }
 
 void PluginEditor::resized()
 {
-    // Layout: 3 EQ columns (160 px each) + 1 master column (80 px)
+    background = {};
+
+    // Layout: one EQ column (160 px) per band + 1 master column (80 px)
     // Knobs: 80 x 80 px, centred in their column cell
     // Labels attached above via attachToComponent — give 24 px headroom per row
 
@@ -88,6 +208,7 @@ void PluginEditor::resized()
     const int rowHeight   = labelHeight + knobSize;
     const int colW        = 160;
     const int startX      = 40;
+    const int numBands    = PluginProcessor::numBands;
 
     auto placeKnob = [&] (juce::Slider& s, int col, int row)
     {
@@ -96,26 +217,58 @@ void PluginEditor::resized()
         s.setBounds (x, y, knobSize, knobSize);
     };
 
-    // Low Shelf column (col 0)
-    placeKnob (lowFreqSlider,  0, 0);
-    placeKnob (lowGainSlider,  0, 1);
-    placeKnob (lowQSlider,     0, 2);
+    // Band columns: shape on three rows, then the dynamics row with the
+    // toggle over smaller threshold and ratio knobs
+    const int dynamicsY = topMargin + 3 * rowHeight;
+    const int smallKnob = 60;
 
-    // Mid Bell column (col 1)
-    placeKnob (midFreqSlider,  1, 0);
-    placeKnob (midGainSlider,  1, 1);
-    placeKnob (midQSlider,     1, 2);
+    for (int col = 0; col < numBands; ++col)
+    {
+        auto& c = bandControls[(size_t) col];
+        placeKnob (c.freq, col, 0);
+        placeKnob (c.gain, col, 1);
+        placeKnob (c.q,    col, 2);
 
-    // High Shelf column (col 2)
-    placeKnob (highFreqSlider, 2, 0);
-    placeKnob (highGainSlider, 2, 1);
-    placeKnob (highQSlider,    2, 2);
+        const int x = startX + col * colW;
+        c.dynamic.setBounds   (x + (colW - 90) / 2, dynamicsY, 90, 24);
+        c.threshold.setBounds (x + 10,                    dynamicsY + 24 + labelHeight, smallKnob, smallKnob);
+        c.ratio.setBounds     (x + colW - 10 - smallKnob, dynamicsY + 24 + labelHeight, smallKnob, smallKnob);
+    }
 
-    // Master column (col 3, narrower — centre in 80 px)
-    const int masterX = startX + 3 * colW + (80 - knobSize) / 2;
+    // Master column (after the bands, narrower — centre in 80 px)
+    const int masterX = startX + numBands * colW + (80 - knobSize) / 2;
     const int masterY = topMargin + labelHeight;
     masterGainSlider.setBounds (masterX, masterY, knobSize, knobSize);
 
+    // Oversampling and phase choices under the master knob, overhanging to the right
+    const int boxX = startX + numBands * colW;
+    oversamplingBox.setBounds       (boxX, topMargin + rowHeight + labelHeight, 150, 24);
+    oversamplingFilterBox.setBounds (boxX, topMargin + rowHeight + labelHeight + 32, 150, 24);
+    phaseModeBox.setBounds          (boxX, topMargin + rowHeight + labelHeight + 64, 150, 24);
+
+    // Transient shaper knobs side by side on the bottom row
+    const int punchY = topMargin + 2 * rowHeight + labelHeight;
+    attackSlider.setBounds  (boxX,      punchY, knobSize, knobSize);
+    sustainSlider.setBounds (boxX + 90, punchY, knobSize, knobSize);
+
+    // Stereo mode, and which set the band columns edit, under the punch knobs
+    stereoModeBox.setBounds (boxX, punchY + knobSize + 8, 150, 24);
+    bandSetBox.setBounds    (boxX, punchY + knobSize + 40, 150, 24);
+
+    // Sidechain ducking: what it ducks, then threshold and range, down one column
+    const int duckX = boxX + 200;
+    duckTargetBox.setBounds       (duckX, masterY, 90, 24);
+    duckThresholdSlider.setBounds (duckX + 5, topMargin + rowHeight + labelHeight, knobSize, knobSize);
+    duckRangeSlider.setBounds     (duckX + 5, punchY, knobSize, knobSize);
+
+    // Response curve under the dynamics row, then the analyser, across the whole editor
+    const int stripY = dynamicsY + 24 + labelHeight + smallKnob + 10;
+    responseCurve.setBounds (startX / 2, stripY, getWidth() - startX, 140);
+    analyser.setBounds      (startX / 2, stripY + 146, getWidth() - startX, 140);
+
+    // Load readout to the right of the inspect button
+    performance.setBounds (getWidth() / 2 + 60, getHeight() - 28, getWidth() / 2 - 80, 16);
+
     // Inspect button at the bottom
     inspectButton.setBounds (getWidth() / 2 - 50, getHeight() - 34, 100, 28);
 }
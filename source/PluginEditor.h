@@ -1,11 +1,15 @@
 #pragma once
 
+#include "PerformanceOverlay.h"
 #include "PluginProcessor.h"
+#include "ResponseCurveDisplay.h"
+#include "SpectrumAnalyser.h"
 #include "BinaryData.h"
 #include "melatonin_inspector/melatonin_inspector.h"
 
 //==============================================================================
-class PluginEditor : public juce::AudioProcessorEditor
+class PluginEditor : public juce::AudioProcessorEditor,
+                     private juce::Timer
 {
 public:
     explicit PluginEditor (PluginProcessor&);
@@ -16,30 +20,70 @@ public:
     void resized() override;
 
 private:
-    using SliderAttachment = juce::AudioProcessorValueTreeState::SliderAttachment;
+    // Attached to the parameter objects rather than through the APVTS. Host
+    // automation doesn't reach the parameters' listeners, so the timer brings
+    // the controls up to date whenever the processor's host change count moves.
+    using SliderAttachment   = juce::SliderParameterAttachment;
+    using ComboBoxAttachment = juce::ComboBoxParameterAttachment;
+    using ButtonAttachment   = juce::ButtonParameterAttachment;
 
     PluginProcessor& processorRef;
     std::unique_ptr<melatonin::Inspector> inspector;
     juce::TextButton inspectButton { "Inspect the UI" };
 
-    // Sliders — declared before attachments (attachments must be destroyed first)
-    juce::Slider lowFreqSlider,  lowGainSlider,  lowQSlider;
-    juce::Slider midFreqSlider,  midGainSlider,  midQSlider;
-    juce::Slider highFreqSlider, highGainSlider, highQSlider;
-    juce::Slider masterGainSlider;
+    // One column of controls per band. Sliders come before attachments in
+    // every group below, so the attachments are destroyed first.
+    struct BandControls
+    {
+        juce::Slider freq, gain, q, threshold, ratio;
+        juce::Label freqLabel, gainLabel, qLabel, thresholdLabel, ratioLabel;
+        juce::ToggleButton dynamic { "Dynamic" };
+
+        std::unique_ptr<SliderAttachment> freqAttach, gainAttach, qAttach, thresholdAttach, ratioAttach;
+        std::unique_ptr<ButtonAttachment> dynamicAttach;
+    };
+
+    std::array<BandControls, (size_t) PluginProcessor::numBands> bandControls;
 
-    juce::Label lowFreqLabel,  lowGainLabel,  lowQLabel;
-    juce::Label midFreqLabel,  midGainLabel,  midQLabel;
-    juce::Label highFreqLabel, highGainLabel, highQLabel;
+    juce::Slider masterGainSlider;
+    juce::Slider attackSlider, sustainSlider;
+    juce::Slider duckThresholdSlider, duckRangeSlider;
     juce::Label masterGainLabel;
+    juce::Label attackLabel, sustainLabel;
+    juce::Label duckThresholdLabel, duckRangeLabel;
+
+    juce::ComboBox oversamplingBox, oversamplingFilterBox, phaseModeBox, stereoModeBox, duckTargetBox;
+
+    // Which parameter set the band columns show; editor state only
+    juce::ComboBox bandSetBox;
+
+    // The EQ curve, then the pre/post spectrum, across the bottom
+    ResponseCurveDisplay responseCurve { processorRef };
+    SpectrumAnalyser analyser { processorRef };
+
+    // Audio-thread load, top right
+    PerformanceOverlay performance { processorRef };
+
+    // Background and headings, drawn on the first paint after a resize at
+    // the pixel size painted to, backgroundScale times ours
+    juce::Image background;
+    float backgroundScale = 1.0f;
+
+    juce::uint32 hostChangesShown = 0;
 
     // Attachments — declared after sliders, destroyed before sliders
-    std::unique_ptr<SliderAttachment> lowFreqAttach,  lowGainAttach,  lowQAttach;
-    std::unique_ptr<SliderAttachment> midFreqAttach,  midGainAttach,  midQAttach;
-    std::unique_ptr<SliderAttachment> highFreqAttach, highGainAttach, highQAttach;
     std::unique_ptr<SliderAttachment> masterGainAttach;
+    std::unique_ptr<SliderAttachment> attackAttach, sustainAttach;
+    std::unique_ptr<SliderAttachment> duckThresholdAttach, duckRangeAttach;
+    std::unique_ptr<ComboBoxAttachment> oversamplingAttach, oversamplingFilterAttach, phaseModeAttach, stereoModeAttach, duckTargetAttach;
+
+    template <typename Attachment, typename Control>
+    std::unique_ptr<Attachment> attach (const juce::String& paramID, Control&);
 
     void configureRotary (juce::Slider&, juce::Label&, const juce::String&);
+    void attachBandControls (int set);
+    void drawBackground (juce::Graphics&);
+    void timerCallback() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginEditor)
 };
@@ -4,63 +4,121 @@
 using namespace juce;
 
 //==============================================================================
+juce::String PluginProcessor::getParameterID (int parameterIndex)
+{
+    static constexpr const char* globalIDs[FirstBandParameter] { "masterGain", "attack", "sustain", "duckThreshold", "duckRange" };
+    static constexpr const char* bandSuffixes[numBandParameters] { "Freq", "Gain", "Q", "Dynamic", "Threshold", "Ratio" };
+
+    if (parameterIndex < FirstBandParameter)
+        return globalIDs[parameterIndex];
+
+    // Set B shares set A's IDs with a "B" on the end
+    const auto bandIndex = parameterIndex - FirstBandParameter;
+    const auto set       = bandIndex / (numBands * numBandParameters);
+    const auto band      = (bandIndex / numBandParameters) % numBands;
+    return juce::String (BandLayout::bands[(size_t) band].id) + bandSuffixes[bandIndex % numBandParameters] + (set == 0 ? "" : "B");
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout PluginProcessor::createParameterLayout()
 {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
+    // Same order as ParameterIndex
     params.push_back (std::make_unique<juce::AudioParameterFloat> (
-        "masterGain", "Master Gain",
+        getParameterID (MasterGain), "Master Gain",
         juce::NormalisableRange<float> (0.0f, 1.0f, 0.001f),
         0.5f));
 
-    // Low Shelf
-    {
-        juce::NormalisableRange<float> freqRange (20.0f, 800.0f, 0.1f);
-        freqRange.setSkewForCentre (200.0f);
-        params.push_back (std::make_unique<juce::AudioParameterFloat> ("lowFreq", "Low Freq", freqRange, 200.0f));
-    }
+    // Transient shaper
     params.push_back (std::make_unique<juce::AudioParameterFloat> (
-        "lowGain", "Low Gain",
+        getParameterID (Attack), "Attack",
         juce::NormalisableRange<float> (-12.0f, 12.0f, 0.1f),
         0.0f));
-    {
-        juce::NormalisableRange<float> qRange (0.1f, 10.0f, 0.01f);
-        qRange.setSkewForCentre (1.0f);
-        params.push_back (std::make_unique<juce::AudioParameterFloat> ("lowQ", "Low Q", qRange, 0.707f));
-    }
-
-    // Mid Peak/Bell
-    {
-        juce::NormalisableRange<float> freqRange (200.0f, 8000.0f, 0.1f);
-        freqRange.setSkewForCentre (1000.0f);
-        params.push_back (std::make_unique<juce::AudioParameterFloat> ("midFreq", "Mid Freq", freqRange, 1000.0f));
-    }
     params.push_back (std::make_unique<juce::AudioParameterFloat> (
-        "midGain", "Mid Gain",
+        getParameterID (Sustain), "Sustain",
         juce::NormalisableRange<float> (-12.0f, 12.0f, 0.1f),
         0.0f));
-    {
-        juce::NormalisableRange<float> qRange (0.1f, 10.0f, 0.01f);
-        qRange.setSkewForCentre (1.0f);
-        params.push_back (std::make_unique<juce::AudioParameterFloat> ("midQ", "Mid Q", qRange, 1.0f));
-    }
 
-    // High Shelf
-    {
-        juce::NormalisableRange<float> freqRange (1000.0f, 20000.0f, 0.1f);
-        freqRange.setSkewForCentre (8000.0f);
-        params.push_back (std::make_unique<juce::AudioParameterFloat> ("highFreq", "High Freq", freqRange, 8000.0f));
-    }
+    // Sidechain ducking: how loud the key has to get, and the most it takes off
     params.push_back (std::make_unique<juce::AudioParameterFloat> (
-        "highGain", "High Gain",
-        juce::NormalisableRange<float> (-12.0f, 12.0f, 0.1f),
-        0.0f));
+        getParameterID (DuckThreshold), "Duck Threshold",
+        juce::NormalisableRange<float> (-60.0f, 0.0f, 0.1f),
+        -30.0f));
+    params.push_back (std::make_unique<juce::AudioParameterFloat> (
+        getParameterID (DuckRange), "Duck Range",
+        juce::NormalisableRange<float> (0.0f, 24.0f, 0.1f),
+        12.0f));
+
+    // Every band of each set: shape, then dynamics
+    for (int index = 0; index < numChannelSets * numBands; ++index)
     {
+        const int set  = index / numBands;
+        const int band = index % numBands;
+        const auto& spec = BandLayout::bands[(size_t) band];
+        const auto name  = (set == 0 ? juce::String() : juce::String ("B ")) + spec.name;
+        auto id = [band, set] (BandParameter p) { return getParameterID (bandParameterIndex (band, p, set)); };
+
+        juce::NormalisableRange<float> freqRange (spec.minFreq, spec.maxFreq, 0.1f);
+        freqRange.setSkewForCentre (spec.defaultFreq);
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (id (BandParameter::Freq), name + " Freq", freqRange, spec.defaultFreq));
+
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (
+            id (BandParameter::Gain), name + " Gain",
+            juce::NormalisableRange<float> (-12.0f, 12.0f, 0.1f),
+            0.0f));
+
         juce::NormalisableRange<float> qRange (0.1f, 10.0f, 0.01f);
         qRange.setSkewForCentre (1.0f);
-        params.push_back (std::make_unique<juce::AudioParameterFloat> ("highQ", "High Q", qRange, 0.707f));
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (id (BandParameter::Q), name + " Q", qRange, spec.defaultQ));
+
+        params.push_back (std::make_unique<juce::AudioParameterBool> (id (BandParameter::Dynamic), name + " Dynamic", false));
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (
+            id (BandParameter::Threshold), name + " Threshold",
+            juce::NormalisableRange<float> (-60.0f, 0.0f, 0.1f),
+            -20.0f));
+
+        juce::NormalisableRange<float> ratioRange (1.0f, 10.0f, 0.01f);
+        ratioRange.setSkewForCentre (3.0f);
+        params.push_back (std::make_unique<juce::AudioParameterFloat> (id (BandParameter::Ratio), name + " Ratio", ratioRange, 2.0f));
     }
 
+    // Filter topology: a hidden engineering switch, so it is neither
+    // automatable nor shown in the editor. Only read at block boundaries.
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        "filterTopology", "Filter Topology",
+        juce::StringArray { "Biquad", "SVF" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
+
+    // Oversampling changes latency, so it can't be automated either
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        "oversampling", "Oversampling",
+        juce::StringArray { "1x", "2x", "4x" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        "oversamplingFilter", "Oversampling Filter",
+        juce::StringArray { "Min Phase (IIR)", "Linear Phase (FIR)" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        "phaseMode", "Phase Mode",
+        juce::StringArray { "Minimum Phase", "Linear Phase" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
+
+    // Which signals sets A and B filter. Switching clears the filters, so
+    // this is a setup choice too.
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        "stereoMode", "Stereo Mode",
+        juce::StringArray { "Linked", "Mid/Side", "Left/Right" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
+
+    // What the sidechain ducks, as duckTargetOff, duckTargetMaster and duckTargetBand() number them
+    juce::StringArray duckTargets { "Off", "Master" };
+    for (const auto& spec : BandLayout::bands)
+        duckTargets.add (spec.name);
+
+    params.push_back (std::make_unique<juce::AudioParameterChoice> (
+        "duckTarget", "Duck Target", duckTargets, duckTargetOff,
+        juce::AudioParameterChoiceAttributes().withAutomatable (false)));
+
     return { params.begin(), params.end() };
 }
 
@@ -70,26 +128,47 @@ PluginProcessor::PluginProcessor()
                     #if ! JucePlugin_IsMidiEffect
                      #if ! JucePlugin_IsSynth
                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                      #endif
                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                     #endif
                       ),
       apvts (*this, nullptr, "PARAMETERS", createParameterLayout())
 {
-    rawLowFreq    = apvts.getRawParameterValue ("lowFreq");
-    rawLowGain    = apvts.getRawParameterValue ("lowGain");
-    rawLowQ       = apvts.getRawParameterValue ("lowQ");
-    rawMidFreq    = apvts.getRawParameterValue ("midFreq");
-    rawMidGain    = apvts.getRawParameterValue ("midGain");
-    rawMidQ       = apvts.getRawParameterValue ("midQ");
-    rawHighFreq   = apvts.getRawParameterValue ("highFreq");
-    rawHighGain   = apvts.getRawParameterValue ("highGain");
-    rawHighQ      = apvts.getRawParameterValue ("highQ");
-    rawMasterGain = apvts.getRawParameterValue ("masterGain");
+    auto choice = [this] (const char* paramID) { return dynamic_cast<juce::AudioParameterChoice*> (apvts.getParameter (paramID)); };
+    filterTopologyParam     = choice ("filterTopology");
+    oversamplingParam       = choice ("oversampling");
+    oversamplingFilterParam = choice ("oversamplingFilter");
+    phaseModeParam          = choice ("phaseMode");
+    stereoModeParam         = choice ("stereoMode");
+    duckTargetParam         = choice ("duckTarget");
+
+    const auto& hostParameters = getParameters();
+    jassert (hostParameters.size() == numHostParameters);
+
+    for (int i = 0; i < numHostParameters; ++i)
+    {
+        auto* param = dynamic_cast<juce::RangedAudioParameter*> (hostParameters[i]);
+        jassert (param != nullptr && (i >= NumParameters || param->getParameterID() == getParameterID (i)));
+        parameterPtrs[(size_t) i] = param;
+
+        if (i < NumParameters)
+            floatParams[(size_t) i] = dynamic_cast<juce::AudioParameterFloat*> (param);
+
+        // clap-juce-extensions derives each CLAP param id from the hash of the JUCE parameter ID
+        clapParamIDs[(size_t) i]   = static_cast<juce::uint32> (param->getParameterID().hashCode());
+        clapParamIndex[(size_t) i] = { clapParamIDs[(size_t) i], i };
+    }
+
+    std::sort (clapParamIndex.begin(), clapParamIndex.end());
+
+    loadPresetBank (getDefaultPresetBankFile());
+    startTimerHz (30);
 }
 
 PluginProcessor::~PluginProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -127,27 +206,47 @@ bool PluginProcessor::isMidiEffect() const
 
 double PluginProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailSeconds.load();
 }
 
 int PluginProcessor::getNumPrograms()
 {
+    // Hosts expect at least one, even with no bank
+    if (const auto* bank = activeBank.load())
+        return juce::jmax (1, bank->size());
+
     return 1;
 }
 
 int PluginProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load();
 }
 
 void PluginProcessor::setCurrentProgram (int index)
 {
-    juce::ignoreUnused (index);
+    // Lock-free either way: some hosts call this from the audio thread
+    const auto* bank = activeBank.load (std::memory_order_acquire);
+    if (bank == nullptr || ! juce::isPositiveAndBelow (index, bank->size()))
+        return;
+
+    currentProgram = index;
+
+    if (preparedToPlay)
+    {
+        pendingProgram.store (index, std::memory_order_release);
+        return;
+    }
+
+    pendingProgram = -1;
+    applyProgram (*bank, index, false);
 }
 
 const juce::String PluginProcessor::getProgramName (int index)
 {
-    juce::ignoreUnused (index);
+    if (const auto* bank = activeBank.load())
+        return bank->getName (index);
+
     return {};
 }
 
@@ -160,39 +259,195 @@ void PluginProcessor::changeProgramName (int index, const juce::String& newName)
 void PluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
+    maxBlockSize      = samplesPerBlock;
+
+    const int numChannels = juce::jmin (getTotalNumOutputChannels(), maxChannels);
+    activeStereoMode = requestedStereoMode();
+    duckTarget = duckTargetOff; // the first block keys whatever is asked for
+    withActiveEngine ([this, numChannels] (auto& engine) { prepareEngine (engine, numChannels); });
+    activeTopology = static_cast<FilterTopology> (filterTopologyParam->getIndex());
 
-    // Pre-initialise every filter to a 2nd-order bypass BEFORE prepare().
-    // The default Filter() constructor creates a 1st-order filter.  If we
-    // called prepare() first, check() would see order mismatch and call
-    // reset() (heap allocation) on the audio thread when coefficients are
-    // later updated.  By assigning a 6-element array now, assignImpl<6>
-    // pre-allocates storage for order=2 and prepare() sets up the correct
-    // delay-state size.
-    const std::array<float, 6> bypass2nd {{ 1.f, 0.f, 0.f, 1.f, 0.f, 0.f }};
-    *leftChain.get<LowShelf>().coefficients   = bypass2nd;
-    *leftChain.get<PeakBell>().coefficients   = bypass2nd;
-    *leftChain.get<HighShelf>().coefficients  = bypass2nd;
-    *rightChain.get<LowShelf>().coefficients  = bypass2nd;
-    *rightChain.get<PeakBell>().coefficients  = bypass2nd;
-    *rightChain.get<HighShelf>().coefficients = bypass2nd;
+    eventQueue.clear();
+    silentSamples = 0;
+    bypassed = false;
 
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate       = sampleRate;
-    spec.maximumBlockSize = static_cast<juce::uint32> (samplesPerBlock);
-    spec.numChannels      = 1;
+    // The double path hands the linear-phase engine float copies
+    if (isUsingDoublePrecision())
+        linearPhaseScratch.setSize (numChannels, samplesPerBlock);
+    else
+        linearPhaseScratch.setSize (0, 0);
 
-    leftChain.prepare (spec);
-    rightChain.prepare (spec);
+    // Starting in linear phase designs the first kernel right here. Minimum
+    // phase doesn't build the engine at all, which across a session of
+    // instances saves a thread and a few hundred KB each.
+    {
+        const juce::ScopedLock sl (linearPhaseLock);
+        preparedToPlay = true;
 
-    smoothedGain.reset (sampleRate, 0.05);
-    smoothedGain.setCurrentAndTargetValue (rawMasterGain->load());
+        if (requestedPhaseMode() == PhaseMode::Linear)
+            prepareLinearPhase();
+        else
+            releaseLinearPhase();
+    }
 
-    lastParams = {};            // force coefficient update on first processBlock
-    updateFilters (readParams());
+    setProcessingMode (oversamplingParam->getIndex(),
+                       static_cast<OversamplingFilter> (oversamplingFilterParam->getIndex()),
+                       requestedPhaseMode());
+    reportLatency();
+}
+
+template <typename SampleType>
+void PluginProcessor::prepareEngine (Engine<SampleType>& engine, int numChannels)
+{
+    using Oversampling = juce::dsp::Oversampling<SampleType>;
+
+    for (int order = 1; order <= maxOversamplingOrder; ++order)
+    {
+        for (const auto filter : { OversamplingFilter::PolyphaseIIR, OversamplingFilter::LinearPhaseFIR })
+        {
+            const auto type = filter == OversamplingFilter::PolyphaseIIR
+                                ? Oversampling::filterHalfBandPolyphaseIIR
+                                : Oversampling::filterHalfBandFIREquiripple;
+
+            auto& os = engine.oversamplers[(size_t) ((order - 1) * 2 + (int) filter)];
+            os = std::make_unique<Oversampling> ((size_t) numChannels, (size_t) order, type, true, true);
+            os->initProcessing ((size_t) maxBlockSize);
+        }
+    }
+
+    // EQ changes ramp over 20 ms, at whichever rate the oversampling leaves us
+    const double maxSampleRate = currentSampleRate * (1 << maxOversamplingOrder);
+    engine.biquadEq.prepare (currentSampleRate, 0.02, maxSampleRate);
+    engine.svfEq.prepare (currentSampleRate, 0.02, maxSampleRate);
+    engine.biquadEq.setStereoMode (activeStereoMode);
+    engine.svfEq.setStereoMode (activeStereoMode);
+
+    engine.transientShaper.setAmounts (rawParam (Attack), rawParam (Sustain));
+    engine.transientShaper.prepare (currentSampleRate);
+
+    engine.ducker.setAmounts (rawParam (DuckThreshold), rawParam (DuckRange));
+    engine.ducker.prepare (currentSampleRate);
+
+    for (int index = 0; index < numChannelSets * numBands; ++index)
+    {
+        engine.biquadEq.setKeyed (index, false);
+        engine.svfEq.setKeyed (index, false);
+    }
 }
 
 void PluginProcessor::releaseResources()
 {
+    const juce::ScopedLock sl (linearPhaseLock);
+    preparedToPlay = false;
+    releaseLinearPhase();
+    retiredBanks.clear();
+}
+
+bool PluginProcessor::loadPresetBank (const juce::File& file)
+{
+    auto bank = std::make_unique<PresetBank>();
+    if (! bank->open (file))
+        return false;
+
+    pendingProgram = -1;
+    currentProgram = 0;
+    activeBank.store (bank.get());
+
+    if (presetBank != nullptr)
+        retiredBanks.push_back ({ std::move (presetBank), audioEpoch.load() });
+
+    presetBank = std::move (bank);
+
+    // Program 0 is what the host is told is current, so that is what the
+    // parameters hold: now, or at the top of the next block while playing
+    setCurrentProgram (0);
+    updateHostDisplay (juce::AudioProcessorListener::ChangeDetails().withProgramChanged (true));
+    return true;
+}
+
+juce::File PluginProcessor::getDefaultPresetBankFile()
+{
+    return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+        .getChildFile (JucePlugin_Name)
+        .getChildFile ("Presets.mjpb");
+}
+
+void PluginProcessor::setAnalyserEnabled (bool shouldBeEnabled)
+{
+    if (shouldBeEnabled && ! analyserPre.isPrepared())
+    {
+        analyserPre.prepare (analyserFifoSize);
+        analyserPost.prepare (analyserFifoSize);
+    }
+
+    analyserEnabled.store (shouldBeEnabled, std::memory_order_release);
+}
+
+void PluginProcessor::applyProgram (const PresetBank& bank, int program, bool onAudioThread)
+{
+    // Everything the preset doesn't mention goes back to its default. On the
+    // audio thread this is a burst of parameter events at the block start;
+    // the changed bands ramp like any other change.
+    for (int i = 0; i < NumParameters; ++i)
+    {
+        auto* param = parameterPtrs[(size_t) i];
+        float plain {};
+        const auto normalised = bank.find (program, clapParamIDs[(size_t) i], i, plain) ? param->convertTo0to1 (plain)
+                                                                                          : param->getDefaultValue();
+
+        if (onAudioThread)
+        {
+            // Unlike host automation this change is ours, so once the timer
+            // passes it on the host hears about it too
+            param->setValue (normalised);
+            pendingNotifications[(size_t) i].store (true, std::memory_order_release);
+        }
+        else
+            param->setValueNotifyingHost (normalised);
+    }
+}
+
+void PluginProcessor::freeRetiredBanks()
+{
+    // A block that started after the swap can only have seen the new bank,
+    // and the one running during it has finished once the epoch moves on
+    const auto epoch = audioEpoch.load();
+    retiredBanks.erase (std::remove_if (retiredBanks.begin(), retiredBanks.end(),
+                                        [epoch] (const RetiredBank& retired) { return retired.epoch != epoch; }),
+                        retiredBanks.end());
+}
+
+void PluginProcessor::applyPendingProgram()
+{
+    const int program = pendingProgram.exchange (-1, std::memory_order_acquire);
+    if (program < 0)
+        return;
+
+    if (const auto* bank = activeBank.load (std::memory_order_acquire))
+        applyProgram (*bank, program, true);
+}
+
+void PluginProcessor::prepareLinearPhase()
+{
+    // Called with linearPhaseLock held, while the audio thread is either
+    // stopped or keeping away because linearPhaseReady is clear
+    const int numChannels = juce::jmin (getTotalNumOutputChannels(), maxChannels);
+    const auto order = oversamplingParam->getIndex();
+
+    linearPhaseReady = false;
+    linearPhaseEq.prepare (currentSampleRate, currentSampleRate * (1 << order), numChannels, toLinearPhaseCurve (readParams()));
+    linearPhaseReady.store (true, std::memory_order_release);
+}
+
+void PluginProcessor::releaseLinearPhase()
+{
+    linearPhaseReady = false;
+    linearPhaseEq.release();
+}
+
+PluginProcessor::PhaseMode PluginProcessor::requestedPhaseMode() const noexcept
+{
+    return static_cast<PhaseMode> (phaseModeParam->getIndex());
 }
 
 bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -201,13 +456,23 @@ bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
     juce::ignoreUnused (layouts);
     return true;
   #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any main layout from mono up to 7.1.4; processing doesn't care which
+    // channel is which
+    const auto numChannels = layouts.getMainOutputChannelSet().size();
+    if (numChannels < 1 || numChannels > maxChannels)
         return false;
 
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // The sidechain, when there is one, is mono or stereo
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto key = layouts.getChannelSet (true, 1);
+        if (! key.isDisabled() && key != juce::AudioChannelSet::mono() && key != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
     return true;
@@ -216,122 +481,667 @@ bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 
 PluginProcessor::FilterParams PluginProcessor::readParams() const noexcept
 {
-    return { rawLowFreq->load(),  rawLowGain->load(),  rawLowQ->load(),
-             rawMidFreq->load(),  rawMidGain->load(),  rawMidQ->load(),
-             rawHighFreq->load(), rawHighGain->load(), rawHighQ->load() };
+    FilterParams p;
+    for (int index = 0; index < numChannelSets * numBands; ++index)
+    {
+        const int set  = index / numBands;
+        const int band = index % numBands;
+        p.bands[(size_t) index] = { rawBandParam (band, BandParameter::Freq, set),
+                                    rawBandParam (band, BandParameter::Gain, set),
+                                    rawBandParam (band, BandParameter::Q, set),
+                                    { rawBandParam (band, BandParameter::Dynamic, set) >= 0.5f,
+                                      rawBandParam (band, BandParameter::Threshold, set),
+                                      rawBandParam (band, BandParameter::Ratio, set) } };
+    }
+    return p;
+}
+
+void PluginProcessor::snapFilters (const FilterParams& p)
+{
+    const Telemetry::ScopedTimer timer (telemetry, Telemetry::Filters);
+
+    // Coefficients are plain values stored inline in the chain, so updating
+    // them on the audio thread never allocates. Set B is kept current even
+    // while linked, ready for a switch to a split mode.
+    withActiveEq ([&p] (auto& eq) {
+        for (size_t band = 0; band < p.bands.size(); ++band)
+        {
+            const auto& bp = p.bands[band];
+            eq.snapBand ((int) band, bp.freq, bp.gain, bp.q);
+            eq.setDynamics ((int) band, bp.dynamics.enabled, bp.dynamics.threshold, bp.dynamics.ratio);
+        }
+    });
+
+    requestLinearPhaseCurve (p);
+    tailSeconds = computeTailSeconds (p, activeStereoMode);
+    lastParams = p;
 }
 
 void PluginProcessor::updateFilters (const FilterParams& p)
 {
-    using namespace juce;
-    const float sr = static_cast<float> (currentSampleRate);
+    const Telemetry::ScopedTimer timer (telemetry, Telemetry::Filters);
+
+    // Changed bands start ramping towards their new settings. Dynamics
+    // changes apply at once; the detector smooths them anyway.
+    withActiveEq ([this, &p] (auto& eq) {
+        for (size_t band = 0; band < p.bands.size(); ++band)
+        {
+            const auto& bp   = p.bands[band];
+            const auto& last = lastParams.bands[band];
+
+            if (bp.freq != last.freq || bp.gain != last.gain || bp.q != last.q)
+                eq.rampBand ((int) band, bp.freq, bp.gain, bp.q);
+
+            if (bp.dynamics != last.dynamics)
+                eq.setDynamics ((int) band, bp.dynamics.enabled, bp.dynamics.threshold, bp.dynamics.ratio);
+        }
+    });
+
+    requestLinearPhaseCurve (p);
+    tailSeconds = computeTailSeconds (p, activeStereoMode);
+    lastParams = p;
+}
+
+void PluginProcessor::updateTopology()
+{
+    const auto topology = static_cast<FilterTopology> (filterTopologyParam->getIndex());
+    if (topology == activeTopology)
+        return;
+
+    // The other chain has been idle, so start it from silence at the current
+    // settings. The switch itself isn't smoothed; it is not meant for use
+    // while audio is playing.
+    activeTopology = topology;
+    withActiveEq ([] (auto& eq) { eq.reset(); });
+    snapFilters (readParams());
+}
+
+StereoMode PluginProcessor::requestedStereoMode() const noexcept
+{
+    if (getMainBusNumInputChannels() != 2)
+        return StereoMode::Linked;
+
+    return static_cast<StereoMode> (stereoModeParam->getIndex());
+}
+
+void PluginProcessor::updateStereoMode()
+{
+    const auto mode = requestedStereoMode();
+    if (mode == activeStereoMode)
+        return;
+
+    // Both chains follow, so a topology switch keeps the mode. Like that
+    // switch, this starts from silence rather than crossfading.
+    activeStereoMode = mode;
+    withActiveEngine ([mode] (auto& engine) {
+        engine.biquadEq.setStereoMode (mode);
+        engine.svfEq.setStereoMode (mode);
+    });
+    snapFilters (readParams());
+}
+
+void PluginProcessor::updateProcessingMode()
+{
+    const auto order  = oversamplingParam->getIndex();
+    const auto filter = static_cast<OversamplingFilter> (oversamplingFilterParam->getIndex());
+    auto mode         = requestedPhaseMode();
+
+    // Linear phase waits for the timer to build its engine
+    if (mode == PhaseMode::Linear && ! linearPhaseReady.load (std::memory_order_acquire))
+        mode = PhaseMode::Minimum;
+
+    if (order != oversamplingOrder || filter != oversamplingFilter || mode != phaseMode)
+        setProcessingMode (order, filter, mode);
+}
+
+void PluginProcessor::updateDuckTarget (bool hasKey)
+{
+    const auto target = hasKey ? duckTargetParam->getIndex() : duckTargetOff;
+    if (target == duckTarget)
+        return;
+
+    // Ducking starts again from nothing, and a band no longer keyed goes
+    // straight back to its set gain
+    duckTarget = target;
+    withActiveEngine ([target] (auto& engine) {
+        engine.ducker.reset();
+
+        for (int index = 0; index < numChannelSets * numBands; ++index)
+        {
+            const bool keyed = target == duckTargetBand (index % numBands);
+            engine.biquadEq.setKeyed (index, keyed);
+            engine.svfEq.setKeyed (index, keyed);
+        }
+    });
+}
+
+void PluginProcessor::setProcessingMode (int order, OversamplingFilter filter, PhaseMode mode)
+{
+    jassert (juce::isPositiveAndNotGreaterThan (order, maxOversamplingOrder));
+
+    oversamplingOrder  = order;
+    oversamplingFilter = filter;
+    phaseMode          = mode;
+
+    // Linear phase convolves at the host rate; the oversampling setting only
+    // decides which biquads its curve copies.
+    const bool linear = mode == PhaseMode::Linear;
+    const double rate = currentSampleRate * (1 << order);
+    int oversamplerLatency = 0;
+
+    withActiveEngine ([&] (auto& engine) {
+        engine.activeOversampler = order > 0 && ! linear ? engine.oversamplers[(size_t) ((order - 1) * 2 + (int) filter)].get() : nullptr;
+
+        if (engine.activeOversampler != nullptr)
+        {
+            engine.activeOversampler->reset();
+            oversamplerLatency = juce::roundToInt (engine.activeOversampler->getLatencyInSamples());
+        }
+
+        // Everything downstream of the upsampler runs at the oversampled rate.
+        // Like a topology switch, this starts from silence rather than crossfading.
+        // The prewarp tables for every rate were filled in prepareToPlay.
+        engine.biquadEq.setSampleRate (rate);
+        engine.svfEq.setSampleRate (rate);
+
+        engine.smoothedGain.reset (linear ? currentSampleRate : rate, 0.05);
+        engine.smoothedGain.setCurrentAndTargetValue (rawParam (MasterGain));
+    });
+
+    if (linearPhaseReady.load (std::memory_order_acquire))
+        linearPhaseEq.reset();
+
+    snapFilters (readParams());
+
+    processingLatency = linear ? linearPhaseEq.getLatencySamples() : oversamplerLatency;
+    pendingLatency.store (processingLatency, std::memory_order_release);
+}
+
+void PluginProcessor::reportLatency()
+{
+    const int latency = pendingLatency.exchange (-1, std::memory_order_acquire);
+    if (latency >= 0)
+        setLatencySamples (latency);
+}
+
+LinearPhaseEq<PluginProcessor::numBands>::Curve PluginProcessor::toLinearPhaseCurve (const FilterParams& p) noexcept
+{
+    LinearPhaseEq<numBands>::Curve curve;
+    for (size_t band = 0; band < curve.size(); ++band)
+        curve[band] = { p.bands[band].freq, p.bands[band].gain, p.bands[band].q };
+    return curve;
+}
+
+double PluginProcessor::computeTailSeconds (const FilterParams& p, StereoMode mode) noexcept
+{
+    // Bands in series ring one after another, so a set's tail is the sum of
+    // its bands'; a dynamic band may be cut by up to the detector's maximum.
+    // Both sets run side by side in the split modes, so take the longer.
+    constexpr double decayDb = -silenceThresholdDb;
+    const int numSets = mode == StereoMode::Linked ? 1 : numChannelSets;
+    double longest = 0.0;
+
+    for (int set = 0; set < numSets; ++set)
+    {
+        double total = 0.0;
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            const auto& bp  = p.bands[(size_t) (set * numBands + band)];
+            const auto type = bandTypes[(size_t) band];
+            auto seconds = FilterDesign::decaySeconds (type, bp.freq, bp.gain, bp.q, decayDb);
+
+            if (bp.dynamics.enabled)
+            {
+                const auto cutGain = bp.gain - BandDetector<double, numBands>::maxReductionDb;
+                seconds = juce::jmax (seconds, FilterDesign::decaySeconds (type, bp.freq, cutGain, bp.q, decayDb));
+            }
+
+            total += seconds;
+        }
+
+        longest = juce::jmax (longest, total);
+    }
+
+    return longest;
+}
+
+void PluginProcessor::requestLinearPhaseCurve (const FilterParams& p) noexcept
+{
+    // Kept up to date in both modes once built, so switching to linear phase
+    // finds a current kernel
+    if (linearPhaseReady.load (std::memory_order_acquire))
+        linearPhaseEq.requestCurve (toLinearPhaseCurve (p), currentSampleRate * (1 << oversamplingOrder));
+}
+
+void PluginProcessor::updateParameters()
+{
+    // Only recalculate biquad coefficients when a parameter has changed.
+    const auto p = readParams();
+    if (p != lastParams)
+        updateFilters (p);
+
+    withActiveEngine ([this] (auto& engine) {
+        engine.smoothedGain.setTargetValue (rawParam (MasterGain));
+        engine.transientShaper.setAmounts (rawParam (Attack), rawParam (Sustain));
+        engine.ducker.setAmounts (rawParam (DuckThreshold), rawParam (DuckRange));
+    });
+}
+
+void PluginProcessor::queueParameterEvent (int parameterIndex, int sampleOffset, float normalisedValue) noexcept
+{
+    jassert (juce::isPositiveAndBelow (parameterIndex, (int) NumParameters));
 
-    // Assign via std::array<float,6> — goes through assignImpl<6> which
-    // normalises by a0, stores 5 values, and is heap-free after prepareToPlay
-    // has pre-allocated capacity for order=2 (8-element internal array).
+    const ParameterEvent event { parameterIndex, sampleOffset, normalisedValue };
 
-    // ── Low Shelf ──────────────────────────────────────────────────────────────
+    // Should the queue ever fill up, land the oldest change early to make
+    // room. Everything queued still applies in order, so each parameter
+    // ends the block on its latest value.
+    if (! eventQueue.push (event))
     {
-        const float A     = std::sqrt (Decibels::decibelsToGain (p.lowGain));
-        const float omega = MathConstants<float>::twoPi * p.lowFreq / sr;
-        const float cosW  = std::cos (omega);
-        const float sinW  = std::sin (omega);
-        const float beta  = sinW * std::sqrt (A) / p.lowQ;
-
-        const float b0 = A * (A + 1.0f - (A - 1.0f) * cosW + beta);
-        const float b1 = 2.0f * A * (A - 1.0f - (A + 1.0f) * cosW);
-        const float b2 = A * (A + 1.0f - (A - 1.0f) * cosW - beta);
-        const float a0 = A + 1.0f + (A - 1.0f) * cosW + beta;
-        const float a1 = -2.0f * (A - 1.0f + (A + 1.0f) * cosW);
-        const float a2 = A + 1.0f + (A - 1.0f) * cosW - beta;
-
-        const std::array<float, 6> c {{ b0, b1, b2, a0, a1, a2 }};
-        *leftChain.get<LowShelf>().coefficients  = c;
-        *rightChain.get<LowShelf>().coefficients = c;
+        ParameterEvent oldest;
+        if (eventQueue.peek (oldest))
+        {
+            applyParameterEvent (oldest);
+            eventQueue.pop();
+        }
+
+        eventQueue.push (event);
     }
+}
+
+void PluginProcessor::applyParameterEvent (const ParameterEvent& event) noexcept
+{
+    // Only the parameter's own atomic value changes here, which is what
+    // readParams() polls. The host sent it, so the listeners aren't told:
+    // the wrapper would echo it back as a change of ours. The editor polls
+    // hostChangeCount instead.
+    parameterPtrs[(size_t) event.parameterIndex]->setValue (event.normalisedValue);
+    hostChangeCount.fetch_add (1, std::memory_order_release);
+}
 
-    // ── Mid Peak/Bell ──────────────────────────────────────────────────────────
+void PluginProcessor::timerCallback()
+{
+    // Build the linear-phase engine off the audio thread, which picks it up
+    // on its next block. Its latency comes back through reportLatency() on
+    // the tick after that, like any other mode switch.
+    if (requestedPhaseMode() == PhaseMode::Linear && ! linearPhaseReady.load())
     {
-        const float A     = std::sqrt (Decibels::decibelsToGain (p.midGain));
-        const float omega = MathConstants<float>::twoPi * p.midFreq / sr;
-        const float cosW  = std::cos (omega);
-        const float sinW  = std::sin (omega);
-        const float alpha = sinW / (2.0f * p.midQ);
-
-        const float b0 = 1.0f + alpha * A;
-        const float b1 = -2.0f * cosW;
-        const float b2 = 1.0f - alpha * A;
-        const float a0 = 1.0f + alpha / A;
-        const float a1 = -2.0f * cosW;
-        const float a2 = 1.0f - alpha / A;
-
-        const std::array<float, 6> c {{ b0, b1, b2, a0, a1, a2 }};
-        *leftChain.get<PeakBell>().coefficients  = c;
-        *rightChain.get<PeakBell>().coefficients = c;
+        const juce::ScopedLock sl (linearPhaseLock);
+        if (preparedToPlay && ! linearPhaseReady.load())
+            prepareLinearPhase();
     }
 
-    // ── High Shelf ─────────────────────────────────────────────────────────────
+    reportLatency();
+    freeRetiredBanks();
+
+    for (size_t i = 0; i < pendingNotifications.size(); ++i)
     {
-        const float A     = std::sqrt (Decibels::decibelsToGain (p.highGain));
-        const float omega = MathConstants<float>::twoPi * p.highFreq / sr;
-        const float cosW  = std::cos (omega);
-        const float sinW  = std::sin (omega);
-        const float beta  = sinW * std::sqrt (A) / p.highQ;
-
-        const float b0 = A * (A + 1.0f + (A - 1.0f) * cosW + beta);
-        const float b1 = -2.0f * A * (A - 1.0f + (A + 1.0f) * cosW);
-        const float b2 = A * (A + 1.0f + (A - 1.0f) * cosW - beta);
-        const float a0 = A + 1.0f - (A - 1.0f) * cosW + beta;
-        const float a1 = 2.0f * (A - 1.0f - (A + 1.0f) * cosW);
-        const float a2 = A + 1.0f - (A - 1.0f) * cosW - beta;
-
-        const std::array<float, 6> c {{ b0, b1, b2, a0, a1, a2 }};
-        *leftChain.get<HighShelf>().coefficients  = c;
-        *rightChain.get<HighShelf>().coefficients = c;
+        if (pendingNotifications[i].exchange (false, std::memory_order_acquire))
+        {
+            auto* param = parameterPtrs[i];
+            param->sendValueChangedMessageToListeners (param->getValue());
+        }
     }
+}
 
-    lastParams = p;
+bool PluginProcessor::supportsDirectEvent (uint16_t spaceId, uint16_t type)
+{
+    return spaceId == CLAP_CORE_EVENT_SPACE_ID && type == CLAP_EVENT_PARAM_VALUE;
+}
+
+void PluginProcessor::handleDirectEvent (const clap_event_header_t* event, int sampleOffset)
+{
+    const auto* paramEvent = reinterpret_cast<const clap_event_param_value_t*> (event);
+
+    const auto found = std::lower_bound (clapParamIndex.begin(), clapParamIndex.end(),
+                                         std::make_pair (static_cast<juce::uint32> (paramEvent->param_id), 0));
+
+    if (found == clapParamIndex.end() || found->first != paramEvent->param_id)
+        return;
+
+    const int index = found->second;
+    const auto value = static_cast<float> (paramEvent->value);
+
+    if (index < NumParameters)
+    {
+        queueParameterEvent (index, sampleOffset, value);
+        return;
+    }
+
+    // The switches aren't sample accurate: set them for the next block,
+    // which reads them from the parameter objects
+    parameterPtrs[(size_t) index]->setValue (value);
+    hostChangeCount.fetch_add (1, std::memory_order_release);
+}
+
+template <typename SampleType>
+bool PluginProcessor::skipSilence (Engine<SampleType>& engine, const juce::AudioBuffer<SampleType>& buffer, int numChannels)
+{
+    // getMagnitude() is a vectorised min/max scan, and stops at the first loud channel
+    const auto threshold = static_cast<SampleType> (juce::Decibels::decibelsToGain (silenceThresholdDb));
+    const int numSamples = buffer.getNumSamples();
+    bool silent = true;
+
+    for (int ch = 0; ch < numChannels && silent; ++ch)
+        silent = buffer.getMagnitude (ch, 0, numSamples) < threshold;
+
+    if (! silent)
+    {
+        if (bypassed)
+            wake (engine);
+
+        silentSamples = 0;
+        return false;
+    }
+
+    // Keep processing until everything already inside, the filters' ringing
+    // and any latency, has come out
+    if (! bypassed)
+    {
+        const auto tailSamples = (juce::int64) std::ceil (tailSeconds.load() * currentSampleRate) + processingLatency;
+        bypassed = silentSamples >= tailSamples;
+        silentSamples += numSamples;
+    }
+
+    return bypassed;
+}
+
+template <typename SampleType>
+void PluginProcessor::wake (Engine<SampleType>& engine)
+{
+    // Whatever was left in the filters had decayed below the threshold, so
+    // start again from clean state at the current settings, as after
+    // prepareToPlay. Ramps and gain changes made while bypassed just land.
+    bypassed = false;
+
+    engine.biquadEq.reset();
+    engine.svfEq.reset();
+    engine.transientShaper.reset();
+    engine.ducker.reset();
+    engine.smoothedGain.setCurrentAndTargetValue (engine.smoothedGain.getTargetValue());
+
+    if (engine.activeOversampler != nullptr)
+        engine.activeOversampler->reset();
+
+    if (linearPhaseReady.load (std::memory_order_acquire))
+        linearPhaseEq.reset();
+
+    snapFilters (readParams());
+}
+
+template <typename SampleType>
+void PluginProcessor::processSegment (Engine<SampleType>& engine, juce::AudioBuffer<SampleType>& buffer, int numChannels,
+                                      const SampleType* const* key, int numKeyChannels, int startSample, int numSamples)
+{
+    std::array<const SampleType*, maxKeyChannels> keyAt {};
+    auto keyFrom = [&] (int position) {
+        for (int ch = 0; ch < numKeyChannels; ++ch)
+            keyAt[(size_t) ch] = key[ch] + position;
+        return keyAt.data();
+    };
+
+    if (duckTarget >= duckTargetBand (0))
+    {
+        // A ducked band takes each step's reduction at the EQ's next control
+        // step, so the EQ goes through a ducker step at a time
+        const int band = duckTarget - duckTargetBand (0);
+
+        for (int position = 0; position < numSamples;)
+        {
+            const int numToDo = juce::jmin (numSamples - position, engine.ducker.getSamplesUntilStep());
+            engine.ducker.process (keyFrom (startSample + position), numKeyChannels, nullptr, 0, numToDo);
+
+            const auto reductionDb = engine.ducker.getReductionDb();
+            withEq (engine, activeTopology, [band, reductionDb] (auto& eq) {
+                for (int set = 0; set < numChannelSets; ++set)
+                    eq.setKeyReductionDb (set * numBands + band, reductionDb);
+            });
+
+            equaliseSegment (engine, buffer, numChannels, startSample + position, numToDo);
+            position += numToDo;
+        }
+    }
+    else
+    {
+        equaliseSegment (engine, buffer, numChannels, startSample, numSamples);
+    }
+
+    // The shaper follows the EQ back at the host rate, whatever the EQ mode
+    std::array<SampleType*, maxChannels> channels {};
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[(size_t) ch] = buffer.getWritePointer (ch, startSample);
+
+    engine.transientShaper.process (channels.data(), numChannels, numSamples);
+
+    // Master ducking comes last, on the way out
+    if (duckTarget == duckTargetMaster)
+        engine.ducker.process (keyFrom (startSample), numKeyChannels, channels.data(), numChannels, numSamples);
+}
+
+template <typename SampleType>
+void PluginProcessor::equaliseSegment (Engine<SampleType>& engine, juce::AudioBuffer<SampleType>& buffer, int numChannels, int startSample, int numSamples)
+{
+    std::array<SampleType*, maxChannels> channels {};
+
+    if (phaseMode == PhaseMode::Linear)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[(size_t) ch] = buffer.getWritePointer (ch, startSample);
+
+        processLinearPhase (channels.data(), numChannels, numSamples);
+        applyGain (engine, channels.data(), numChannels, numSamples);
+        return;
+    }
+
+    if (engine.activeOversampler == nullptr)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[(size_t) ch] = buffer.getWritePointer (ch, startSample);
+
+        filterAndGain (engine, activeTopology, channels.data(), numChannels, numSamples);
+        return;
+    }
+
+    const auto block = juce::dsp::AudioBlock<SampleType> (buffer).getSubsetChannelBlock (0, (size_t) numChannels);
+
+    // The oversamplers are sized for maxBlockSize, so anything longer goes through in pieces
+    for (int position = 0; position < numSamples; position += maxBlockSize)
+    {
+        auto subBlock = block.getSubBlock ((size_t) (startSample + position), (size_t) juce::jmin (maxBlockSize, numSamples - position));
+        const auto upsampled = engine.activeOversampler->processSamplesUp (subBlock);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[(size_t) ch] = upsampled.getChannelPointer ((size_t) ch);
+
+        filterAndGain (engine, activeTopology, channels.data(), numChannels, (int) upsampled.getNumSamples());
+        engine.activeOversampler->processSamplesDown (subBlock);
+    }
+}
+
+template <typename SampleType>
+void PluginProcessor::processLinearPhase (SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        linearPhaseEq.process (channels, numChannels, numSamples);
+    }
+    else
+    {
+        // The convolution engine is float only, and its own rounding is far
+        // above float's anyway, so double goes through a float copy.
+        const int scratchSize = linearPhaseScratch.getNumSamples();
+
+        for (int position = 0; position < numSamples; position += scratchSize)
+        {
+            const int numToDo = juce::jmin (scratchSize, numSamples - position);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* scratch = linearPhaseScratch.getWritePointer (ch);
+                for (int i = 0; i < numToDo; ++i)
+                    scratch[i] = static_cast<float> (channels[ch][position + i]);
+            }
+
+            linearPhaseEq.process (linearPhaseScratch.getArrayOfWritePointers(), numChannels, numToDo);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto* scratch = linearPhaseScratch.getReadPointer (ch);
+                for (int i = 0; i < numToDo; ++i)
+                    channels[ch][position + i] = static_cast<SampleType> (scratch[i]);
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void PluginProcessor::filterAndGain (Engine<SampleType>& engine, FilterTopology topology, SampleType* const* channels, int numChannels, int numSamples)
+{
+    // Filter every channel through all the bands and apply the smoothed
+    // master gain in the same pass over the buffer.
+    const Telemetry::ScopedTimer timer (telemetry, Telemetry::GainLoop);
+    auto& smoothedGain = engine.smoothedGain;
+
+    withEq (engine, topology, [&] (auto& eq) {
+        if (smoothedGain.isSmoothing())
+        {
+            eq.process (channels, numChannels, numSamples, [&smoothedGain] { return smoothedGain.getNextValue(); });
+        }
+        else
+        {
+            const SampleType gain = smoothedGain.getTargetValue();
+            eq.process (channels, numChannels, numSamples, [gain] { return gain; });
+        }
+    });
+}
+
+template <typename SampleType>
+void PluginProcessor::applyGain (Engine<SampleType>& engine, SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    const Telemetry::ScopedTimer timer (telemetry, Telemetry::GainLoop);
+    auto& smoothedGain = engine.smoothedGain;
+
+    if (! smoothedGain.isSmoothing())
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::multiply (channels[ch], smoothedGain.getTargetValue(), numSamples);
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const SampleType gain = smoothedGain.getNextValue();
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch][i] *= gain;
+    }
 }
 
 void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused (midiMessages);
+    jassert (! isUsingDoublePrecision());
+
+    processBlockWith (floatEngine, buffer);
+}
+
+void PluginProcessor::processBlock (juce::AudioBuffer<double>& buffer,
+                                    juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    jassert (isUsingDoublePrecision());
 
+    processBlockWith (doubleEngine, buffer);
+}
+
+template <typename SampleType>
+void PluginProcessor::processBlockWith (Engine<SampleType>& engine, juce::AudioBuffer<SampleType>& buffer)
+{
+    const Telemetry::ScopedTimer timer (telemetry, Telemetry::Block);
     juce::ScopedNoDenormals noDenormals;
-    auto totalNumInputChannels  = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    audioEpoch.fetch_add (1);
 
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+    auto mainNumInputChannels  = getMainBusNumInputChannels();
+    auto mainNumOutputChannels = getMainBusNumOutputChannels();
+
+    for (auto i = mainNumInputChannels; i < mainNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // Only recalculate biquad coefficients when a parameter has changed.
-    const auto p = readParams();
-    if (p != lastParams)
-        updateFilters (p);
+    const int numChannels = juce::jmin (mainNumInputChannels, maxChannels);
+    const int numSamples  = buffer.getNumSamples();
+
+    // The sidechain is read in place, from after the main input in the
+    // host's buffer
+    std::array<const SampleType*, maxKeyChannels> key {};
+    const int numKeyChannels = getBusCount (true) > 1 ? juce::jmin (getChannelCountOfBus (true, 1), maxKeyChannels) : 0;
+    for (int ch = 0; ch < numKeyChannels; ++ch)
+        key[(size_t) ch] = buffer.getReadPointer (getChannelIndexInProcessBlockBuffer (true, 1, ch));
+
+    // Changes made between blocks land at the start of the block. That covers
+    // the editor and VST3, whose JUCE wrapper only hands us the last point of
+    // each parameter queue.
+    updateTopology();
+    updateStereoMode();
+    updateProcessingMode();
+    updateDuckTarget (numKeyChannels > 0);
+    applyPendingProgram();
+    updateParameters();
 
-    juce::dsp::AudioBlock<float> block (buffer);
+    // The analyser's share of the block: a mono mix of the input now and of
+    // the output at the end, copied into FIFOs the editor reads
+    const bool analysing = analyserEnabled.load (std::memory_order_acquire);
+    if (analysing)
+        analyserPre.push (buffer.getArrayOfReadPointers(), numChannels, numSamples);
 
-    auto leftBlock = block.getSingleChannelBlock (0);
-    leftChain.process (juce::dsp::ProcessContextReplacing<float> (leftBlock));
+    // Timestamped host events (CLAP) split the block, so automation lands on
+    // the right sample whatever the host buffer size, and coefficients are
+    // only recalculated at those split points. A silent block past the tail
+    // skips all of that; its events still drain below.
+    ParameterEvent event;
+    int position = skipSilence (engine, buffer, numChannels) ? numSamples : 0;
 
-    if (totalNumInputChannels > 1)
+    while (position < numSamples)
     {
-        auto rightBlock = block.getSingleChannelBlock (1);
-        rightChain.process (juce::dsp::ProcessContextReplacing<float> (rightBlock));
+        if (eventQueue.peek (event) && event.sampleOffset <= position)
+        {
+            do
+            {
+                applyParameterEvent (event);
+                eventQueue.pop();
+            } while (eventQueue.peek (event) && event.sampleOffset <= position);
+
+            updateParameters();
+        }
+
+        const int segmentEnd = eventQueue.nextOffset (numSamples);
+        processSegment (engine, buffer, numChannels, key.data(), numKeyChannels, position, segmentEnd - position);
+        position = segmentEnd;
     }
 
-    // Apply master gain with per-sample smoothing to avoid clicks.
-    smoothedGain.setTargetValue (rawMasterGain->load());
-    const int numSamples = buffer.getNumSamples();
-    for (int i = 0; i < numSamples; ++i)
+    // Events stamped past the end of the block take effect from the next one.
+    while (eventQueue.peek (event))
     {
-        const float gain = smoothedGain.getNextValue();
-        for (int ch = 0; ch < totalNumInputChannels; ++ch)
-            buffer.getWritePointer (ch)[i] *= gain;
+        applyParameterEvent (event);
+        eventQueue.pop();
+    }
+
+    if (analysing)
+        analyserPost.push (buffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+    if constexpr (Telemetry::enabled)
+    {
+        telemetry.addSamples (numSamples);
+        telemetry.setCoefficientDesigns (countCoefficientDesigns());
     }
 }
 
+juce::uint64 PluginProcessor::countCoefficientDesigns() const noexcept
+{
+    return floatEngine.biquadEq.getNumDesigned() + floatEngine.svfEq.getNumDesigned()
+         + doubleEngine.biquadEq.getNumDesigned() + doubleEngine.svfEq.getNumDesigned();
+}
+
 //==============================================================================
 bool PluginProcessor::hasEditor() const
 {
@@ -346,13 +1156,18 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 //==============================================================================
 void PluginProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml (state.createXml());
-    copyXmlToBinary (*xml, destData);
+    StateFormat::write (getParameters(), destData);
 }
 
 void PluginProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+    if (StateFormat::isBinary (data, sizeInBytes))
+    {
+        StateFormat::read (getParameters(), data, sizeInBytes);
+        return;
+    }
+
+    // Sessions saved before the binary format hold the APVTS state as XML
     std::unique_ptr<juce::XmlElement> xml (getXmlFromBinary (data, sizeInBytes));
     if (xml != nullptr && xml->hasTagName (apvts.state.getType()))
         apvts.replaceState (juce::ValueTree::fromXml (*xml));
@@ -2,19 +2,94 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "AnalyserFifo.h"
+#include "BandLayout.h"
+#include "dsp/Ducker.h"
+#include "dsp/EqChain.h"
+#include "dsp/LinearPhaseEq.h"
+#include "dsp/TransientShaper.h"
+#include "ParameterEventQueue.h"
+#include "PresetBank.h"
+#include "StateFormat.h"
+#include "Telemetry.h"
+#include <clap-juce-extensions/clap-juce-extensions.h>
 
 #if (MSVC)
 #include "ipps.h"
 #endif
 
-class PluginProcessor : public juce::AudioProcessor
+class PluginProcessor : public juce::AudioProcessor,
+                        public clap_juce_extensions::clap_juce_audio_processor_capabilities,
+                        private juce::Timer
 {
 public:
-    // Type aliases
-    using MonoFilter = juce::dsp::IIR::Filter<float>;
-    using MonoChain  = juce::dsp::ProcessorChain<MonoFilter, MonoFilter, MonoFilter>;
+    static constexpr int numBands = BandLayout::numBands;
 
-    enum ChainIndex { LowShelf = 0, PeakBell = 1, HighShelf = 2 };
+    // Up to 7.1.4; anything wider is refused in isBusesLayoutSupported()
+    static constexpr int maxChannels = 12;
+
+    // The optional sidechain input bus is mono or stereo
+    static constexpr int maxKeyChannels = 2;
+
+    // Type aliases — one chain filters every channel, four to a group of SIMD
+    // lanes. Both topologies are built; the hidden "filterTopology" parameter
+    // picks one.
+    template <typename SampleType>
+    using BiquadEq = EqChain<SampleType, BiquadTopology, numBands, 4, maxChannels>;
+    template <typename SampleType>
+    using SvfEq    = EqChain<SampleType, SvfTopology, numBands, 4, maxChannels>;
+
+    enum class FilterTopology { Biquad = 0, Svf };
+
+    // Oversampling around the EQ: order 0, 1, 2 is 1x, 2x, 4x
+    enum class OversamplingFilter { PolyphaseIIR = 0, LinearPhaseFIR };
+    static constexpr int maxOversamplingOrder = 2;
+
+    // Minimum phase runs the IIR chain; linear phase the FFT convolution engine
+    enum class PhaseMode { Minimum = 0, Linear };
+
+    // Two sets of band parameters: A is used on its own when linked, and for
+    // mid or left in the split modes; B is side or right. The split modes
+    // need a stereo bus and fall back to Linked on any other.
+    static constexpr int numChannelSets = 2;
+
+    // What the sidechain ducks, in the order the "duckTarget" choice lists
+    // them: nothing, the master gain, or one band (in every set in use).
+    // Ducking needs the optional sidechain bus; without it there is none.
+    // Like dynamic bands, a ducked band stays at its set gain in linear phase.
+    static constexpr int duckTargetOff = 0, duckTargetMaster = 1;
+    static constexpr int duckTargetBand (int band) noexcept { return 2 + band; }
+
+    // Host-facing parameter order, matching createParameterLayout(): the
+    // global parameters, then each band's in BandLayout order for set A,
+    // then the same again for set B.
+    enum ParameterIndex
+    {
+        MasterGain = 0,
+        Attack,
+        Sustain,
+        DuckThreshold,
+        DuckRange,
+        FirstBandParameter
+    };
+
+    enum class BandParameter { Freq = 0, Gain, Q, Dynamic, Threshold, Ratio, NumBandParameters };
+
+    static constexpr int numBandParameters = (int) BandParameter::NumBandParameters;
+    static constexpr int NumParameters     = FirstBandParameter + numChannelSets * numBands * numBandParameters;
+
+    // The non-automatable switches (topology, oversampling, its filter, phase
+    // mode, stereo mode, duck target) follow the ParameterIndex ones
+    static constexpr int numSwitchParameters = 6;
+    static constexpr int numHostParameters   = NumParameters + numSwitchParameters;
+
+    static constexpr int bandParameterIndex (int band, BandParameter p, int set = 0) noexcept
+    {
+        return FirstBandParameter + (set * numBands + band) * numBandParameters + (int) p;
+    }
+
+    // The parameter ID for a ParameterIndex
+    static juce::String getParameterID (int parameterIndex);
 
     PluginProcessor();
     ~PluginProcessor() override;
@@ -25,6 +100,44 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    // Double precision runs the whole IIR path, coefficient design included,
+    // in double. Worth it for low shelves at high sample rates.
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+
+    // Queues a host parameter change to land sampleOffset samples into the next
+    // processBlock. Audio thread only, called before that processBlock.
+    void queueParameterEvent (int parameterIndex, int sampleOffset, float normalisedValue) noexcept;
+
+    // Tells the host about a latency change the audio thread has posted, if
+    // there is one. Message thread; the timer and prepareToPlay call it.
+    void reportLatency();
+
+    // Maps a bank of presets as the plugin's programs, replacing any loaded
+    // before, and makes the first current. Message thread. The constructor
+    // loads getDefaultPresetBankFile() if there is one.
+    bool loadPresetBank (const juce::File& file);
+    static juce::File getDefaultPresetBankFile();
+
+    // Audio-thread timings and counters so far. Any thread; compare two
+    // snapshots for rates and load.
+    Telemetry::Snapshot getTelemetry() const noexcept { return telemetry.snapshot(); }
+
+    // The editor's analyser: the input and the output, each mixed to mono and
+    // pushed from processBlock while an analyser is showing. Message thread;
+    // the first enable allocates the FIFOs.
+    void setAnalyserEnabled (bool shouldBeEnabled);
+    AnalyserFifo& getAnalyserFifo (bool post) noexcept { return post ? analyserPost : analyserPre; }
+
+    // CLAP: we take parameter events ourselves so they keep their sample offsets
+    bool supportsDirectEvent (uint16_t spaceId, uint16_t type) override;
+    void handleDirectEvent (const clap_event_header_t* event, int sampleOffset) override;
+
+    // Host changes land on the parameters without telling their listeners,
+    // or the wrapper would send them back to the host as ours. This count
+    // moves with each one instead, for the editor to poll. Any thread.
+    juce::uint32 getHostChangeCount() const noexcept { return hostChangeCount.load (std::memory_order_acquire); }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -49,35 +162,232 @@ public:
     juce::AudioProcessorValueTreeState apvts;
 
 private:
-    MonoChain leftChain, rightChain;
+    static constexpr const auto& bandTypes = BandLayout::types;
+
+    // Everything on the audio path that depends on the sample type. There is
+    // one per precision, and only the one the host asked for is prepared.
+    template <typename SampleType>
+    struct Engine
+    {
+        BiquadEq<SampleType> biquadEq { bandTypes };
+        SvfEq<SampleType> svfEq { bandTypes };
+
+        // One oversampler per order above 1x and filter type, all built in
+        // prepareToPlay so switching between them never allocates.
+        std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, maxOversamplingOrder * 2> oversamplers;
+        juce::dsp::Oversampling<SampleType>* activeOversampler {}; // nullptr at 1x
+
+        // Punch stage after the EQ, always at the host rate
+        TransientShaper<SampleType> transientShaper;
+
+        // Sidechain ducking, at the host rate
+        Ducker<SampleType> ducker;
+
+        // Smoothed master gain — eliminates clicks when the master knob moves fast.
+        juce::SmoothedValue<SampleType, juce::ValueSmoothingTypes::Linear> smoothedGain;
+    };
+
+    Engine<float> floatEngine;
+    Engine<double> doubleEngine;
+
+    FilterTopology activeTopology { FilterTopology::Biquad };
     double currentSampleRate { 44100.0 };
+    int maxBlockSize { 0 };
+    StereoMode activeStereoMode { StereoMode::Linked };
+    int oversamplingOrder { 0 };
+    OversamplingFilter oversamplingFilter { OversamplingFilter::PolyphaseIIR };
+    int duckTarget { duckTargetOff };
+
+    // Latency of the current processing mode. The audio thread only posts a
+    // change in pendingLatency: telling the host takes JUCE's listener lock,
+    // so prepareToPlay or the timer does that in reportLatency().
+    int processingLatency { 0 };
+    std::atomic<int> pendingLatency { -1 };
+
+    // Same curve as the IIR chain, designed and convolved in the frequency
+    // domain. Kernels are rebuilt on its own background thread, so dynamic
+    // bands stay at their set gain in linear phase, and it is always linked,
+    // on set A. Always float; the double path converts through
+    // linearPhaseScratch.
+    //
+    // Its buffers and thread only exist once linear phase is asked for: in
+    // prepareToPlay, or from the timer when the mode changes while playing.
+    // Until linearPhaseReady is set the audio thread leaves it alone and
+    // stays in minimum phase. linearPhaseLock keeps those two apart.
+    LinearPhaseEq<numBands> linearPhaseEq { bandTypes };
+    PhaseMode phaseMode { PhaseMode::Minimum };
+    juce::AudioBuffer<float> linearPhaseScratch;
+    std::atomic<bool> linearPhaseReady { false };
+    juce::CriticalSection linearPhaseLock;
+    std::atomic<bool> preparedToPlay { false };
+
+    // Programs. While prepared, setCurrentProgram() only posts the index and
+    // the audio thread applies the preset at the top of its next block, the
+    // same way as parameter events. A bank replaced while playing may still
+    // be in use by the block running at the time, so it is retired with the
+    // audioEpoch it was swapped out at. Every block bumps audioEpoch before
+    // it reads activeBank, so once it has moved on the timer can free the bank.
+    struct RetiredBank
+    {
+        std::unique_ptr<PresetBank> bank;
+        juce::uint32 epoch {};
+    };
+
+    std::unique_ptr<PresetBank> presetBank;
+    std::atomic<const PresetBank*> activeBank {};
+    std::vector<RetiredBank> retiredBanks;
+    std::atomic<juce::uint32> audioEpoch { 0 };
+    std::atomic<int> pendingProgram { -1 };
+    std::atomic<int> currentProgram { 0 };
+
+    // The switches (populated in constructor body). Read from the parameter
+    // objects, like rawParam(), so a change set on the audio thread counts
+    // from the next block whether or not the listeners have heard of it.
+    juce::AudioParameterChoice* filterTopologyParam {};
+    juce::AudioParameterChoice* oversamplingParam {};
+    juce::AudioParameterChoice* oversamplingFilterParam {};
+    juce::AudioParameterChoice* phaseModeParam {};
+    juce::AudioParameterChoice* stereoModeParam {};
+    juce::AudioParameterChoice* duckTargetParam {};
+
+    // Parameter objects and their CLAP ids, indexed by ParameterIndex, with
+    // the switches after them in host order. floatParams is null for the bool
+    // parameters. The CLAP id is the hash of the parameter ID, which is also
+    // how saved states and presets key their values.
+    std::array<juce::RangedAudioParameter*, numHostParameters> parameterPtrs {};
+    std::array<juce::AudioParameterFloat*, NumParameters> floatParams {};
+    std::array<juce::uint32, numHostParameters> clapParamIDs {};
+
+    // CLAP id to host index, sorted by id for handleDirectEvent()
+    std::array<std::pair<juce::uint32, int>, numHostParameters> clapParamIndex {};
+
+    // Parameters changed by a program change on the audio thread, whose
+    // listeners the timer still has to tell
+    std::array<std::atomic<bool>, NumParameters> pendingNotifications {};
+
+    // Bumped for every host change applied without notifying the listeners
+    std::atomic<juce::uint32> hostChangeCount { 0 };
+
+    // Sample-accurate host changes for the current block
+    ParameterEventQueue eventQueue;
 
-    // Cached atomic param pointers (populated in constructor body)
-    std::atomic<float>* rawLowFreq   {};
-    std::atomic<float>* rawLowGain   {};
-    std::atomic<float>* rawLowQ      {};
-    std::atomic<float>* rawMidFreq   {};
-    std::atomic<float>* rawMidGain   {};
-    std::atomic<float>* rawMidQ      {};
-    std::atomic<float>* rawHighFreq  {};
-    std::atomic<float>* rawHighGain  {};
-    std::atomic<float>* rawHighQ     {};
-    std::atomic<float>* rawMasterGain {};
-
-    // Snapshot of EQ params; used to skip coefficient recalc when nothing changed.
+    // Timings of processBlock and the sections under it
+    Telemetry telemetry;
+    juce::uint64 countCoefficientDesigns() const noexcept;
+
+    // Enough for an analyser frame at 192 kHz with plenty to spare. The audio
+    // thread only pushes once analyserEnabled is set, after the FIFOs exist,
+    // and they are never freed, so it can't race an editor closing.
+    static constexpr int analyserFifoSize = 32768;
+    AnalyserFifo analyserPre, analyserPost;
+    std::atomic<bool> analyserEnabled { false };
+
+    // Silence bypass: once the input has stayed under silenceThresholdDb for
+    // longer than the tail plus latency, blocks pass through untouched until
+    // it comes back. tailSeconds follows the band settings, and is what
+    // getTailLengthSeconds() reports.
+    static constexpr double silenceThresholdDb = -120.0;
+    std::atomic<double> tailSeconds { 0.0 };
+    juce::int64 silentSamples { 0 };
+    bool bypassed { false };
+
+    // Snapshot of EQ params, set A then set B, each in BandLayout order (the
+    // same band indices as EqChain); used to skip coefficient recalc when
+    // nothing changed.
+    struct DynamicParams {
+        bool enabled{};
+        float threshold{}, ratio{ 1.0f };
+        bool operator==(const DynamicParams&) const = default;
+    };
+    struct BandParams {
+        float freq{}, gain{}, q{};
+        DynamicParams dynamics;
+        bool operator==(const BandParams&) const = default;
+    };
     struct FilterParams {
-        float lowFreq{}, lowGain{}, lowQ{};
-        float midFreq{}, midGain{}, midQ{};
-        float highFreq{}, highGain{}, highQ{};
+        std::array<BandParams, (size_t) (numChannelSets * numBands)> bands;
         bool operator==(const FilterParams&) const = default;
     };
     FilterParams lastParams;
 
-    // Smoothed master gain — eliminates clicks when the master knob moves fast.
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedGain;
-
     FilterParams readParams() const noexcept;
+    void snapFilters (const FilterParams& p);
     void updateFilters (const FilterParams& p);
+    void updateParameters();
+    void updateTopology();
+    void updateStereoMode();
+    StereoMode requestedStereoMode() const noexcept;
+    void updateProcessingMode();
+    void updateDuckTarget (bool hasKey);
+    void setProcessingMode (int order, OversamplingFilter filter, PhaseMode mode);
+    void requestLinearPhaseCurve (const FilterParams& p) noexcept;
+    void prepareLinearPhase();
+    void releaseLinearPhase();
+    PhaseMode requestedPhaseMode() const noexcept;
+    // Read from the parameter objects rather than the APVTS atomics, which
+    // only follow once listeners have been told
+    float rawParam (int parameterIndex) const noexcept
+    {
+        if (auto* param = floatParams[(size_t) parameterIndex])
+            return param->get();
+
+        return parameterPtrs[(size_t) parameterIndex]->getValue();
+    }
+    float rawBandParam (int band, BandParameter p, int set) const noexcept { return rawParam (bandParameterIndex (band, p, set)); }
+    static LinearPhaseEq<numBands>::Curve toLinearPhaseCurve (const FilterParams& p) noexcept;
+    static double computeTailSeconds (const FilterParams& p, StereoMode mode) noexcept;
+    void applyParameterEvent (const ParameterEvent& event) noexcept;
+    void applyProgram (const PresetBank& bank, int program, bool onAudioThread);
+    void applyPendingProgram();
+    void freeRetiredBanks();
+    void timerCallback() override;
+
+    template <typename SampleType>
+    void prepareEngine (Engine<SampleType>& engine, int numChannels);
+    template <typename SampleType>
+    void processBlockWith (Engine<SampleType>& engine, juce::AudioBuffer<SampleType>& buffer);
+    template <typename SampleType>
+    bool skipSilence (Engine<SampleType>& engine, const juce::AudioBuffer<SampleType>& buffer, int numChannels);
+    template <typename SampleType>
+    void wake (Engine<SampleType>& engine);
+    template <typename SampleType>
+    void processSegment (Engine<SampleType>& engine, juce::AudioBuffer<SampleType>& buffer, int numChannels,
+                         const SampleType* const* key, int numKeyChannels, int startSample, int numSamples);
+    template <typename SampleType>
+    void equaliseSegment (Engine<SampleType>& engine, juce::AudioBuffer<SampleType>& buffer, int numChannels, int startSample, int numSamples);
+    template <typename SampleType>
+    void processLinearPhase (SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    template <typename SampleType>
+    static void filterAndGain (Engine<SampleType>& engine, FilterTopology topology, SampleType* const* channels, int numChannels, int numSamples);
+    template <typename SampleType>
+    static void applyGain (Engine<SampleType>& engine, SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Calls fn with the engine for the precision the host asked for
+    template <typename Fn>
+    decltype (auto) withActiveEngine (Fn&& fn)
+    {
+        if (isUsingDoublePrecision())
+            return fn (doubleEngine);
+
+        return fn (floatEngine);
+    }
+
+    // Calls fn with the EqChain for topology in engine
+    template <typename SampleType, typename Fn>
+    static decltype (auto) withEq (Engine<SampleType>& engine, FilterTopology topology, Fn&& fn)
+    {
+        if (topology == FilterTopology::Svf)
+            return fn (engine.svfEq);
+
+        return fn (engine.biquadEq);
+    }
+
+    // Calls fn with whichever EqChain is active, in the active precision
+    template <typename Fn>
+    void withActiveEq (Fn&& fn)
+    {
+        withActiveEngine ([this, &fn] (auto& engine) { withEq (engine, activeTopology, fn); });
+    }
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "StateFormat.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <bit>
+#include <vector>
+
+//==============================================================================
+/**
+    A bank of presets in one file, memory-mapped read-only.
+
+        uint32  magic ("MJPB")
+        uint16  version
+        uint16  parameters per preset
+        uint32  number of presets
+        uint32  reserved
+        presets: char name[32], UTF-8 and zero-padded, then one
+                 StateFormat record (ID hash, plain value) per parameter
+
+    Every preset is the same size, so finding one is a multiply, and
+    thousands of them cost only the pages a host actually touches, shared
+    between every instance that maps the same file. open() touches all of
+    them once so a program change on the audio thread doesn't fault them in
+    from disk.
+
+    Reading a preset allocates nothing and never blocks, so it is safe on
+    the audio thread. open() and write() are for the message thread.
+*/
+class PresetBank
+{
+public:
+    static constexpr juce::uint32 magic   = 0x42504a4d; // "MJPB" in file order
+    static constexpr juce::uint16 version = 1;
+    static constexpr size_t headerSize    = 16;
+    static constexpr size_t nameBytes     = 32;
+
+    struct Preset
+    {
+        juce::String name;
+        std::vector<float> values; // plain values, one per parameter ID given to write()
+    };
+
+    /** Writes a bank of presets for parameterIDs. */
+    static void write (juce::OutputStream& out, const juce::StringArray& parameterIDs, const std::vector<Preset>& presets)
+    {
+        jassert (parameterIDs.size() <= 0xffff);
+
+        out.writeInt (static_cast<int> (magic));
+        out.writeShort (static_cast<short> (version));
+        out.writeShort (static_cast<short> (parameterIDs.size()));
+        out.writeInt (static_cast<int> (presets.size()));
+        out.writeInt (0);
+
+        for (const auto& preset : presets)
+        {
+            jassert (preset.values.size() == (size_t) parameterIDs.size());
+
+            // Shortened a character at a time, so a multi-byte one is never split
+            auto name = preset.name;
+            while (name.getNumBytesAsUTF8() >= nameBytes)
+                name = name.dropLastCharacters (1);
+
+            std::array<char, nameBytes> padded {};
+            name.copyToUTF8 (padded.data(), padded.size());
+            out.write (padded.data(), padded.size());
+
+            for (int i = 0; i < parameterIDs.size(); ++i)
+            {
+                out.writeInt (static_cast<int> (parameterIDs[i].hashCode()));
+                out.writeFloat (preset.values[(size_t) i]);
+            }
+        }
+    }
+
+    /** Maps file. Returns false, leaving the bank empty, if it isn't a bank
+        this version can read.
+    */
+    bool open (const juce::File& file)
+    {
+        close();
+
+        auto mapped = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly, false);
+        const auto* data = static_cast<const char*> (mapped->getData());
+        const auto size  = mapped->getSize();
+
+        if (data == nullptr || size < headerSize
+            || juce::ByteOrder::littleEndianInt (data) != magic
+            || juce::ByteOrder::littleEndianShort (data + 4) > version)
+            return false;
+
+        const int parameters = juce::ByteOrder::littleEndianShort (data + 6);
+        const int presets    = (int) juce::ByteOrder::littleEndianInt (data + 8);
+        const auto bytes     = nameBytes + StateFormat::recordSize * (size_t) parameters;
+
+        if (presets < 0 || size < headerSize + bytes * (size_t) presets)
+            return false;
+
+        volatile char touched = 0;
+        for (size_t offset = 0; offset < size; offset += 4096)
+            touched = touched + data[offset];
+
+        mappedFile    = std::move (mapped);
+        entries       = data + headerSize;
+        numParameters = parameters;
+        numPresets    = presets;
+        presetBytes   = bytes;
+        return true;
+    }
+
+    void close() noexcept
+    {
+        mappedFile.reset();
+        entries    = nullptr;
+        numPresets = 0;
+    }
+
+    int size() const noexcept { return numPresets; }
+
+    juce::String getName (int preset) const
+    {
+        if (! juce::isPositiveAndBelow (preset, numPresets))
+            return {};
+
+        const auto* name = entry (preset);
+        return juce::String::fromUTF8 (name, (int) strnlen (name, nameBytes));
+    }
+
+    /** Finds the plain value of the parameter whose ID hashes to hash.
+        Records are normally in the order the caller's parameters are in, so
+        the search starts at hint.
+    */
+    bool find (int preset, juce::uint32 hash, int hint, float& plain) const noexcept
+    {
+        if (! juce::isPositiveAndBelow (preset, numPresets) || numParameters == 0)
+            return false;
+
+        const auto* records = entry (preset) + nameBytes;
+
+        for (int n = 0; n < numParameters; ++n)
+        {
+            const auto* record = records + StateFormat::recordSize * (size_t) ((hint + n) % numParameters);
+            if (juce::ByteOrder::littleEndianInt (record) == hash)
+            {
+                plain = std::bit_cast<float> (juce::ByteOrder::littleEndianInt (record + 4));
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    const char* entry (int preset) const noexcept { return entries + presetBytes * (size_t) preset; }
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const char* entries {};
+    int numParameters {}, numPresets {};
+    size_t presetBytes {};
+};
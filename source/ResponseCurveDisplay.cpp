@@ -0,0 +1,213 @@
+#include "ResponseCurveDisplay.h"
+
+ResponseCurveDisplay::ResponseCurveDisplay (PluginProcessor& p)
+    : processorRef (p)
+{
+    using BandParameter = PluginProcessor::BandParameter;
+
+    for (int set = 0; set < PluginProcessor::numChannelSets; ++set)
+    {
+        for (int band = 0; band < numBands; ++band)
+        {
+            // The parameter objects rather than the APVTS copies, which
+            // don't follow host automation
+            auto param = [&] (BandParameter which) {
+                return dynamic_cast<juce::AudioParameterFloat*> (processorRef.apvts.getParameter (PluginProcessor::getParameterID (PluginProcessor::bandParameterIndex (band, which, set))));
+            };
+
+            auto& bp = parameters[(size_t) set][(size_t) band];
+            bp.freq  = param (BandParameter::Freq);
+            bp.gain  = param (BandParameter::Gain);
+            bp.q     = param (BandParameter::Q);
+        }
+    }
+
+    setOpaque (true);
+    startTimerHz (refreshRateHz);
+}
+
+void ResponseCurveDisplay::setChannelSet (int set)
+{
+    if (set == channelSet)
+        return;
+
+    channelSet = set;
+    everythingDirty = true;
+    refresh();
+}
+
+void ResponseCurveDisplay::timerCallback()
+{
+    refresh();
+}
+
+juce::Rectangle<int> ResponseCurveDisplay::refresh()
+{
+    if (! updateBands() || curveImage.isNull())
+        return {};
+
+    const auto dirty = drawCurve (false);
+    if (! dirty.isEmpty())
+        repaint (dirty);
+    return dirty;
+}
+
+bool ResponseCurveDisplay::updateBands()
+{
+    const auto sampleRate = processorRef.getSampleRate() > 0.0 ? processorRef.getSampleRate() : 48000.0;
+    if (sampleRate != curve.getSampleRate())
+    {
+        curve.setSampleRate (sampleRate);
+        everythingDirty = true;
+    }
+
+    bool changed = false;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const auto& bp = parameters[(size_t) channelSet][(size_t) band];
+        const BandValues values { bp.freq->get(), bp.gain->get(), bp.q->get() };
+        auto& last = shown[(size_t) band];
+
+        if (! everythingDirty && values == last)
+            continue;
+
+        last = values;
+        curve.setBand (band, FilterDesign::makeBand<double> (BandLayout::bands[(size_t) band].type, sampleRate, values.freq, values.gain, values.q));
+        changed = true;
+    }
+
+    everythingDirty = false;
+    return changed;
+}
+
+void ResponseCurveDisplay::resized()
+{
+    createImages();
+    drawBackground();
+
+    updateBands();
+    drawCurve (true);
+}
+
+void ResponseCurveDisplay::createImages()
+{
+    const auto width  = juce::jmax (1, juce::roundToInt ((float) getWidth() * imageScale));
+    const auto height = juce::jmax (1, juce::roundToInt ((float) getHeight() * imageScale));
+
+    background = juce::Image (juce::Image::RGB, width, height, false);
+    curveImage = juce::Image (juce::Image::ARGB, width, height, true);
+}
+
+void ResponseCurveDisplay::drawBackground()
+{
+    juce::Graphics g (background);
+    g.addTransform (juce::AffineTransform::scale (imageScale));
+
+    const auto area  = getLocalBounds().toFloat();
+    const auto ratio = std::log (ResponseCurve<numBands>::maxHz / ResponseCurve<numBands>::minHz);
+    auto xFor = [&] (double hz) { return (float) (area.getWidth() * std::log (hz / ResponseCurve<numBands>::minHz) / ratio); };
+    auto yFor = [&] (float db) { return juce::jmap (db, -rangeDb, rangeDb, area.getBottom(), area.getY()); };
+
+    g.fillAll (juce::Colour (0xff1b1f24));
+    g.setFont (11.0f);
+
+    for (auto [hz, label] : { std::pair { 100.0, "100" }, std::pair { 1000.0, "1k" }, std::pair { 10000.0, "10k" } })
+    {
+        const auto x = xFor (hz);
+        g.setColour (juce::Colours::white.withAlpha (0.08f));
+        g.drawVerticalLine (juce::roundToInt (x), area.getY(), area.getBottom());
+        g.setColour (juce::Colours::white.withAlpha (0.4f));
+        g.drawText (label, juce::roundToInt (x) + 3, (int) area.getBottom() - 14, 30, 12, juce::Justification::left);
+    }
+
+    for (float db = -12.0f; db <= 12.0f; db += 6.0f)
+    {
+        const auto y = yFor (db);
+        g.setColour (juce::Colours::white.withAlpha (db == 0.0f ? 0.2f : 0.08f));
+        g.drawHorizontalLine (juce::roundToInt (y), area.getX(), area.getRight());
+        g.setColour (juce::Colours::white.withAlpha (0.4f));
+        g.drawText (juce::String (juce::roundToInt (db)), 3, juce::roundToInt (y) - 12, 30, 12, juce::Justification::left);
+    }
+}
+
+juce::Rectangle<int> ResponseCurveDisplay::drawCurve (bool everything)
+{
+    constexpr int numPoints = ResponseCurve<numBands>::numPoints;
+
+    const auto area = getLocalBounds().toFloat();
+    const auto* db  = curve.getTotalDb();
+    auto xFor = [&] (int point) { return area.getWidth() * (float) point / (float) (numPoints - 1); };
+
+    // Only the stretch of the grid that moved by a visible amount, and the
+    // strip the old and new curves cover over it, gets redrawn
+    int first = numPoints, last = -1;
+    auto top = area.getBottom(), bottom = area.getY();
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const auto y   = juce::jmap (juce::jlimit (-rangeDb, rangeDb, db[i]), -rangeDb, rangeDb, area.getBottom(), area.getY());
+        auto& drawn = drawnY[(size_t) i];
+
+        if (everything || std::abs (y - drawn) > 0.05f)
+        {
+            first  = juce::jmin (first, i);
+            last   = i;
+            top    = juce::jmin (top, y, drawn);
+            bottom = juce::jmax (bottom, y, drawn);
+        }
+
+        drawn = y;
+    }
+
+    if (last < 0)
+        return {};
+
+    // The segments either side of the stretch move too
+    const auto left  = xFor (juce::jmax (0, first - 1));
+    const auto right = xFor (juce::jmin (numPoints - 1, last + 1));
+    for (int i = juce::jmax (0, first - 1); i <= juce::jmin (numPoints - 1, last + 1); ++i)
+    {
+        top    = juce::jmin (top, drawnY[(size_t) i]);
+        bottom = juce::jmax (bottom, drawnY[(size_t) i]);
+    }
+
+    const auto dirty = everything ? getLocalBounds()
+                                  : juce::Rectangle<float>::leftTopRightBottom (left, top, right, bottom)
+                                        .expanded (3.0f).getSmallestIntegerContainer().getIntersection (getLocalBounds());
+
+    curvePath.clear();
+    curvePath.preallocateSpace (3 * numPoints);
+    curvePath.startNewSubPath (xFor (0), drawnY[0]);
+    for (int i = 1; i < numPoints; ++i)
+        curvePath.lineTo (xFor (i), drawnY[(size_t) i]);
+
+    // Clear and clip to the same whole image pixels, so none at the edge of
+    // the area is cleared without being redrawn
+    const auto pixels = (dirty.toFloat() * imageScale).getSmallestIntegerContainer().getIntersection (curveImage.getBounds());
+    curveImage.clear (pixels);
+    juce::Graphics g (curveImage);
+    g.reduceClipRegion (pixels);
+    g.addTransform (juce::AffineTransform::scale (imageScale));
+    g.setColour (juce::Colours::lightskyblue);
+    g.strokePath (curvePath, juce::PathStrokeType (2.0f, juce::PathStrokeType::curved, juce::PathStrokeType::rounded));
+
+    return dirty;
+}
+
+void ResponseCurveDisplay::paint (juce::Graphics& g)
+{
+    // The images match the pixels of whatever this is painted to, which only
+    // shows here. A new scale (another screen, a host zoom) draws them again.
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != imageScale)
+    {
+        imageScale = scale;
+        resized();
+    }
+
+    // Both layers are already drawn; this is two blits of the clip region
+    const auto toLogical = juce::AffineTransform::scale (1.0f / imageScale);
+    g.drawImageTransformed (background, toLogical);
+    g.drawImageTransformed (curveImage, toLogical);
+}
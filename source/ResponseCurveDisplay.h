@@ -0,0 +1,74 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include "dsp/ResponseCurve.h"
+
+//==============================================================================
+/**
+    The EQ's frequency response for the band set being edited.
+
+    A timer compares the band parameters with the values last drawn. Only
+    the bands that moved get new coefficients and a new response row. The
+    grid and labels are drawn into an image once per resize. The curve is
+    drawn into a second image, and only over the area it has moved through.
+    That area is also the only part repainted, so an idle display costs a
+    few atomic loads a tick, and dragging a knob costs one band's row and a
+    strip of pixels.
+*/
+class ResponseCurveDisplay : public juce::Component,
+                             private juce::Timer
+{
+public:
+    static constexpr int refreshRateHz = 30;
+    static constexpr float rangeDb = 18.0f;
+
+    explicit ResponseCurveDisplay (PluginProcessor&);
+
+    // Which set of band parameters to show
+    void setChannelSet (int set);
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    // What the timer does: picks up parameter changes and repaints where the
+    // curve moved. Returns the area repainted, empty if nothing changed.
+    juce::Rectangle<int> refresh();
+
+private:
+    static constexpr int numBands = PluginProcessor::numBands;
+
+    struct BandParameters
+    {
+        juce::AudioParameterFloat* freq {};
+        juce::AudioParameterFloat* gain {};
+        juce::AudioParameterFloat* q {};
+    };
+
+    struct BandValues
+    {
+        float freq {}, gain {}, q {};
+        bool operator== (const BandValues&) const = default;
+    };
+
+    PluginProcessor& processorRef;
+    std::array<std::array<BandParameters, (size_t) numBands>, (size_t) PluginProcessor::numChannelSets> parameters;
+    int channelSet = 0;
+
+    ResponseCurve<numBands> curve;
+    std::array<BandValues, (size_t) numBands> shown {};
+    bool everythingDirty = true;
+
+    // Both images are imageScale times our size, the pixel size last painted at
+    juce::Image background, curveImage;
+    float imageScale = 1.0f;
+    juce::Path curvePath;
+    std::array<float, (size_t) ResponseCurve<numBands>::numPoints> drawnY {};
+
+    void timerCallback() override;
+    bool updateBands();
+    void createImages();
+    void drawBackground();
+    juce::Rectangle<int> drawCurve (bool everything);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseCurveDisplay)
+};
@@ -0,0 +1,93 @@
+#include "SpectrumAnalyser.h"
+
+SpectrumAnalyser::SpectrumAnalyser (PluginProcessor& p)
+    : processorRef (p)
+{
+    setOpaque (true);
+    processorRef.setAnalyserEnabled (true);
+
+    // Whatever was left from an editor opened earlier is stale by now
+    processorRef.getAnalyserFifo (false).clear();
+    processorRef.getAnalyserFifo (true).clear();
+
+    startTimerHz (refreshRateHz);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    stopTimer();
+    processorRef.setAnalyserEnabled (false);
+}
+
+void SpectrumAnalyser::updateSpectra()
+{
+    pre.pull (processorRef.getAnalyserFifo (false));
+    post.pull (processorRef.getAnalyserFifo (true));
+    pre.update();
+    post.update();
+}
+
+void SpectrumAnalyser::timerCallback()
+{
+    updateSpectra();
+    repaint();
+}
+
+void SpectrumAnalyser::buildPath (juce::Path& path, const SpectrumAnalysis& analysis, juce::Rectangle<float> area, bool closed) const
+{
+    const auto sampleRate = processorRef.getSampleRate() > 0.0 ? processorRef.getSampleRate() : 48000.0;
+    const auto width      = juce::roundToInt (area.getWidth());
+    const auto ratio      = std::log (maxHz / minHz);
+
+    // One point per pixel column, at the loudest bin the column covers
+    auto frequencyAt = [&] (float x) { return minHz * std::exp (ratio * x / (float) width); };
+    auto yFor = [&] (float db) { return juce::jmap (juce::jlimit (minDb, maxDb, db), minDb, maxDb, area.getBottom(), area.getY()); };
+
+    path.clear();
+    path.preallocateSpace (3 * (width + 4));
+
+    for (int x = 0; x <= width; ++x)
+    {
+        const auto y = yFor (analysis.getPeakLevel (frequencyAt ((float) x - 0.5f), frequencyAt ((float) x + 0.5f), sampleRate));
+
+        if (x == 0)
+            path.startNewSubPath (area.getX(), y);
+        else
+            path.lineTo (area.getX() + (float) x, y);
+    }
+
+    if (closed)
+    {
+        path.lineTo (area.getRight(), area.getBottom());
+        path.lineTo (area.getX(), area.getBottom());
+        path.closeSubPath();
+    }
+}
+
+void SpectrumAnalyser::paint (juce::Graphics& g)
+{
+    auto area = getLocalBounds().toFloat();
+    g.fillAll (juce::Colour (0xff15181c));
+
+    // Decades and every 12 dB
+    g.setColour (juce::Colours::white.withAlpha (0.08f));
+    for (float hz : { 100.0f, 1000.0f, 10000.0f })
+        g.drawVerticalLine (juce::roundToInt (area.getWidth() * std::log (hz / minHz) / std::log (maxHz / minHz)), area.getY(), area.getBottom());
+    for (float db = maxDb - 6.0f; db > minDb; db -= 12.0f)
+        g.drawHorizontalLine (juce::roundToInt (juce::jmap (db, minDb, maxDb, area.getBottom(), area.getY())), area.getX(), area.getRight());
+
+    // Input filled and dim behind, output as a line on top
+    buildPath (prePath, pre, area, true);
+    g.setColour (juce::Colours::grey.withAlpha (0.35f));
+    g.fillPath (prePath);
+
+    buildPath (postPath, post, area, false);
+    g.setColour (juce::Colours::orange);
+    g.strokePath (postPath, juce::PathStrokeType (1.5f));
+
+    g.setColour (juce::Colours::white.withAlpha (0.6f));
+    g.setFont (12.0f);
+    g.drawText ("In", 6, 4, 40, 14, juce::Justification::left);
+    g.setColour (juce::Colours::orange);
+    g.drawText ("Out", 6, 18, 40, 14, juce::Justification::left);
+}
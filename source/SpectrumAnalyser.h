@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include "dsp/SpectrumAnalysis.h"
+
+//==============================================================================
+/**
+    Pre and post spectrum curves, on a log frequency scale.
+
+    While one exists the processor pushes its input and output into the
+    analyser FIFOs. A 60 Hz timer drains them, runs both analyses and
+    repaints, all on the message thread.
+*/
+class SpectrumAnalyser : public juce::Component,
+                         private juce::Timer
+{
+public:
+    static constexpr int refreshRateHz = 60;
+
+    static constexpr float minHz = 20.0f, maxHz = 20000.0f;
+    static constexpr float minDb = -90.0f, maxDb = 6.0f;
+
+    explicit SpectrumAnalyser (PluginProcessor&);
+    ~SpectrumAnalyser() override;
+
+    void paint (juce::Graphics&) override;
+
+    // What the timer does each frame, short of repainting
+    void updateSpectra();
+
+private:
+    PluginProcessor& processorRef;
+    SpectrumAnalysis pre, post;
+    juce::Path prePath, postPath;
+
+    void timerCallback() override;
+    void buildPath (juce::Path&, const SpectrumAnalysis&, juce::Rectangle<float>, bool closed) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyser)
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <bit>
+
+//==============================================================================
+/**
+    The plugin's saved state: a short header, then one record per parameter.
+
+        uint32  magic ("MJPS")
+        uint16  version
+        uint16  number of records
+        records: uint32 hash of the parameter ID, float32 plain value
+
+    All little-endian. Values are stored in the parameter's own units rather
+    than normalised, so widening a range later doesn't move old settings.
+    Parameters missing from a state go back to their defaults, and records
+    for parameters that no longer exist are skipped.
+
+    Neither side builds a ValueTree or any XML, which matters when a host
+    loads hundreds of instances or snapshots state for undo. States saved
+    before this format are XML; PluginProcessor::setStateInformation() still
+    reads those.
+*/
+namespace StateFormat
+{
+    inline constexpr juce::uint32 magic   = 0x53504a4d; // "MJPS" in file order
+    inline constexpr juce::uint16 version = 1;
+
+    inline constexpr size_t headerSize = 8;
+    inline constexpr size_t recordSize = 8;
+
+    inline juce::uint32 hashOf (const juce::AudioProcessorParameter* param)
+    {
+        const auto* withID = dynamic_cast<const juce::AudioProcessorParameterWithID*> (param);
+        jassert (withID != nullptr);
+        return static_cast<juce::uint32> (withID->paramID.hashCode());
+    }
+
+    /** True if data starts like a state written by write(). */
+    inline bool isBinary (const void* data, int sizeInBytes) noexcept
+    {
+        return data != nullptr && sizeInBytes >= (int) headerSize
+            && juce::ByteOrder::littleEndianInt (data) == magic;
+    }
+
+    /** Replaces dest with the current value of every parameter. */
+    inline void write (const juce::Array<juce::AudioProcessorParameter*>& params, juce::MemoryBlock& dest)
+    {
+        jassert (params.size() <= 0xffff);
+
+        juce::MemoryOutputStream out (dest, false);
+        out.preallocate (headerSize + recordSize * (size_t) params.size());
+
+        out.writeInt (static_cast<int> (magic));
+        out.writeShort (static_cast<short> (version));
+        out.writeShort (static_cast<short> (params.size()));
+
+        for (const auto* param : params)
+        {
+            const auto* ranged = dynamic_cast<const juce::RangedAudioParameter*> (param);
+            jassert (ranged != nullptr);
+
+            out.writeInt (static_cast<int> (hashOf (param)));
+            out.writeFloat (ranged->convertFrom0to1 (ranged->getValue()));
+        }
+    }
+
+    /** Sets every parameter from a state written by write(). Returns false,
+        changing nothing, if the data is truncated or from a newer version.
+    */
+    inline bool read (const juce::Array<juce::AudioProcessorParameter*>& params, const void* data, int sizeInBytes)
+    {
+        if (! isBinary (data, sizeInBytes))
+            return false;
+
+        const auto* in = static_cast<const char*> (data);
+        const int numRecords = juce::ByteOrder::littleEndianShort (in + 6);
+
+        if (juce::ByteOrder::littleEndianShort (in + 4) > version
+            || (size_t) sizeInBytes < headerSize + recordSize * (size_t) numRecords)
+            return false;
+
+        const auto* records = in + headerSize;
+
+        for (int i = 0; i < params.size(); ++i)
+        {
+            auto* param = dynamic_cast<juce::RangedAudioParameter*> (params[i]);
+            jassert (param != nullptr);
+
+            // Records are normally in our own parameter order, so the search
+            // starts where this parameter would be and almost always stops there
+            const auto hash = hashOf (param);
+            auto normalised = param->getDefaultValue();
+
+            for (int n = 0; n < numRecords; ++n)
+            {
+                const auto* record = records + recordSize * (size_t) ((i + n) % numRecords);
+                if (juce::ByteOrder::littleEndianInt (record) == hash)
+                {
+                    const auto plain = std::bit_cast<float> (juce::ByteOrder::littleEndianInt (record + 4));
+                    normalised = param->convertTo0to1 (plain);
+                    break;
+                }
+            }
+
+            if (param->getValue() != normalised)
+                param->setValueNotifyingHost (normalised);
+        }
+
+        return true;
+    }
+}
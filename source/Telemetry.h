@@ -0,0 +1,202 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <bit>
+
+// Set to 0 from CMake (MOJOPUNCH_TELEMETRY=OFF) to compile every timer and
+// counter out. The API stays, and reads as zeros.
+#ifndef MOJOPUNCH_TELEMETRY
+ #define MOJOPUNCH_TELEMETRY 1
+#endif
+
+//==============================================================================
+/**
+    Audio-thread timing, cheap enough to leave on in a release build.
+
+    Each section keeps a count, a total, the worst time seen and a histogram
+    with four buckets per octave of nanoseconds, from 64 ns up to about half
+    a second. Times come from juce::Time::getHighResolutionTicks(). That is
+    the TSC behind the OS clock where the CPU has an invariant one, without
+    needing calibration here.
+
+    There is one writer, the audio thread. Every field is a relaxed atomic
+    it loads and stores, so recording is a few plain moves and never waits.
+    Readers on any thread take a Snapshot. Counters only ever go up, so
+    rates and loads come from the difference between two snapshots.
+*/
+class Telemetry
+{
+public:
+    static constexpr bool enabled = MOJOPUNCH_TELEMETRY != 0;
+
+    enum Section
+    {
+        Block = 0,  // the whole of processBlock
+        Filters,    // turning parameter changes into filter targets
+        GainLoop,   // the filter and master gain pass over the samples
+        NumSections
+    };
+
+    static constexpr int bucketsPerOctave = 4;
+    static constexpr int firstOctave      = 6; // 64 ns
+    static constexpr int numBuckets       = 24 * bucketsPerOctave;
+
+    struct Snapshot
+    {
+        std::array<std::array<juce::uint64, numBuckets>, NumSections> histogram {};
+        std::array<juce::uint64, NumSections> count {}, totalNanos {}, worstNanos {};
+        juce::uint64 samples {}, coefficientDesigns {};
+
+        /** Share of real time processBlock took between earlier and this. */
+        double loadSince (const Snapshot& earlier, double sampleRate) const noexcept
+        {
+            const auto audioNanos = (double) (samples - earlier.samples) * 1.0e9 / sampleRate;
+            return audioNanos > 0.0 ? (double) (totalNanos[Block] - earlier.totalNanos[Block]) / audioNanos : 0.0;
+        }
+
+        /** Time under which a fraction (0..1) of the section's calls fell,
+            to the top of their bucket.
+        */
+        double percentileNanos (Section section, double fraction) const noexcept
+        {
+            return percentileNanos (section, fraction, Snapshot {});
+        }
+
+        /** The same, for only the calls since an earlier snapshot. */
+        double percentileNanos (Section section, double fraction, const Snapshot& earlier) const noexcept
+        {
+            const auto calls = count[(size_t) section] - earlier.count[(size_t) section];
+            if (calls == 0)
+                return 0.0;
+
+            const auto wanted = (juce::uint64) std::ceil (fraction * (double) calls);
+            juce::uint64 seen = 0;
+
+            for (int bucket = 0; bucket < numBuckets; ++bucket)
+            {
+                seen += histogram[(size_t) section][(size_t) bucket] - earlier.histogram[(size_t) section][(size_t) bucket];
+                if (seen >= wanted)
+                    return bucketLowerBound (bucket + 1);
+            }
+
+            return bucketLowerBound (numBuckets);
+        }
+
+        double meanNanos (Section section) const noexcept
+        {
+            return count[(size_t) section] > 0 ? (double) totalNanos[(size_t) section] / (double) count[(size_t) section] : 0.0;
+        }
+    };
+
+    static int bucketFor (juce::uint64 nanos) noexcept
+    {
+        if (nanos < (1u << firstOctave))
+            return 0;
+
+        // The octave, then the two bits under its leading one
+        const int octave = 63 - std::countl_zero (nanos);
+        const auto fraction = (int) ((nanos >> (octave - 2)) & (bucketsPerOctave - 1));
+        return juce::jmin (numBuckets - 1, (octave - firstOctave) * bucketsPerOctave + fraction);
+    }
+
+    /** Buckets split each octave into equal quarters. */
+    static double bucketLowerBound (int bucket) noexcept
+    {
+        const int octave = firstOctave + bucket / bucketsPerOctave;
+        return std::ldexp (1.0 + (double) (bucket % bucketsPerOctave) / bucketsPerOctave, octave);
+    }
+
+    //==============================================================================
+   #if MOJOPUNCH_TELEMETRY
+    static juce::int64 now() noexcept { return juce::Time::getHighResolutionTicks(); }
+
+    /** Audio thread. */
+    void record (Section section, juce::int64 startTicks) noexcept
+    {
+        const auto nanos = (juce::uint64) juce::jmax<juce::int64> (0, now() - startTicks) * nanosPerTickScaled >> tickShift;
+        auto& s = sections[(size_t) section];
+
+        bump (s.histogram[(size_t) bucketFor (nanos)], 1);
+        bump (s.count, 1);
+        bump (s.totalNanos, nanos);
+
+        if (nanos > s.worstNanos.load (std::memory_order_relaxed))
+            s.worstNanos.store (nanos, std::memory_order_relaxed);
+    }
+
+    /** Audio thread. */
+    void addSamples (int numSamples) noexcept { bump (samples, (juce::uint64) numSamples); }
+
+    /** Audio thread. Takes the running total of designs, as the EQ reports it. */
+    void setCoefficientDesigns (juce::uint64 total) noexcept { coefficientDesigns.store (total, std::memory_order_relaxed); }
+
+    Snapshot snapshot() const noexcept
+    {
+        Snapshot result;
+        for (size_t i = 0; i < sections.size(); ++i)
+        {
+            const auto& s = sections[i];
+            for (size_t bucket = 0; bucket < s.histogram.size(); ++bucket)
+                result.histogram[i][bucket] = s.histogram[bucket].load (std::memory_order_relaxed);
+
+            result.count[i]      = s.count.load (std::memory_order_relaxed);
+            result.totalNanos[i] = s.totalNanos.load (std::memory_order_relaxed);
+            result.worstNanos[i] = s.worstNanos.load (std::memory_order_relaxed);
+        }
+
+        result.samples            = samples.load (std::memory_order_relaxed);
+        result.coefficientDesigns = coefficientDesigns.load (std::memory_order_relaxed);
+        return result;
+    }
+
+    /** Times the rest of the enclosing scope into section. */
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer (Telemetry& t, Section s) noexcept : telemetry (t), section (s) {}
+        ~ScopedTimer() noexcept { telemetry.record (section, start); }
+
+    private:
+        Telemetry& telemetry;
+        const Section section;
+        const juce::int64 start = now();
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimer)
+    };
+
+private:
+    static void bump (std::atomic<juce::uint64>& counter, juce::uint64 amount) noexcept
+    {
+        counter.store (counter.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Ticks to nanoseconds as a multiply and shift, worked out once
+    static constexpr int tickShift = 20;
+    inline static const juce::uint64 nanosPerTickScaled =
+        (juce::uint64) std::llround (1.0e9 * (double) (1 << tickShift) / (double) juce::Time::getHighResolutionTicksPerSecond());
+
+    struct SectionCounters
+    {
+        std::array<std::atomic<juce::uint64>, numBuckets> histogram {};
+        std::atomic<juce::uint64> count {}, totalNanos {}, worstNanos {};
+    };
+
+    std::array<SectionCounters, NumSections> sections {};
+    std::atomic<juce::uint64> samples {}, coefficientDesigns {};
+
+   #else
+    static juce::int64 now() noexcept { return 0; }
+    void record (Section, juce::int64) noexcept {}
+    void addSamples (int) noexcept {}
+    void setCoefficientDesigns (juce::uint64) noexcept {}
+    Snapshot snapshot() const noexcept { return {}; }
+
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer (Telemetry&, Section) noexcept {}
+    };
+   #endif
+};
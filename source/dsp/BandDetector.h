@@ -0,0 +1,165 @@
+#pragma once
+
+#include "FastMath.h"
+#include "FilterDesign.h"
+#include <algorithm>
+#include <array>
+
+//==============================================================================
+/**
+    The level detectors behind dynamic EQ bands: one filtered sidechain,
+    envelope follower and threshold/ratio gain computer per band.
+
+    Every band listens to the same input, by default the mean of the
+    channels (or, for one side of a split stereo EQ, a weighted mix of the
+    pair), through its own SVF sidechain (see
+    FilterDesign::makeSvfSidechainPrewarped), so the detectors cost the same
+    whatever the channel count. The per-sample loop runs over all bands at
+    once from struct-of-arrays state, with the envelope's attack/release
+    choice made by select, so it vectorises across bands.
+
+    Gain reduction is only read at control rate, by EqChain, which turns it
+    into a gain offset on the band's coefficients. It is always a cut: a
+    dynamic band pulls its gain down by (level - threshold) * (1 - 1 / ratio)
+    dB once the sidechain goes over the threshold, up to maxReductionDb.
+*/
+template <typename SampleType, int NumBands>
+class BandDetector
+{
+public:
+    static constexpr SampleType attackSeconds   = SampleType (0.005);
+    static constexpr SampleType releaseSeconds  = SampleType (0.12);
+    static constexpr SampleType maxReductionDb  = SampleType (24);
+
+    /** Recomputes every sidechain and the envelope times for the rate, and
+        clears the state.
+    */
+    void setSampleRate (double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        attack  = static_cast<SampleType> (std::exp (-1.0 / (attackSeconds * sampleRate)));
+        release = static_cast<SampleType> (std::exp (-1.0 / (releaseSeconds * sampleRate)));
+
+        for (int band = 0; band < NumBands; ++band)
+            designSidechain (band);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        ic1.fill (SampleType());
+        ic2.fill (SampleType());
+        envelope.fill (SampleType());
+    }
+
+    /** Points a band's sidechain at its frequency and Q. */
+    void setBand (int band, BandType type, SampleType freq, SampleType q) noexcept
+    {
+        const auto i = (size_t) band;
+        types[i]     = type;
+        frequency[i] = freq;
+        quality[i]   = q;
+        designSidechain (band);
+    }
+
+    void setThreshold (int band, SampleType thresholdDb, SampleType ratio) noexcept
+    {
+        jassert (ratio >= SampleType (1));
+
+        threshold[(size_t) band] = thresholdDb;
+        slope[(size_t) band]     = SampleType (1) - SampleType (1) / ratio;
+    }
+
+    /** Runs numChannels channels of input through every sidechain. */
+    void process (const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        const auto channelScale = SampleType (1) / static_cast<SampleType> (juce::jmax (1, numChannels));
+
+        run (numSamples, [=] (int i) {
+            SampleType x {};
+            for (int ch = 0; ch < numChannels; ++ch)
+                x += channels[ch][i];
+            return x * channelScale;
+        });
+    }
+
+    /** Runs a weighted mix of a stereo pair through every sidechain: 0.5 and
+        -0.5 hear the side signal, 1 and 0 the left channel alone.
+    */
+    void processStereo (const SampleType* const* channels, SampleType leftWeight, SampleType rightWeight, int numSamples) noexcept
+    {
+        run (numSamples, [=] (int i) { return leftWeight * channels[0][i] + rightWeight * channels[1][i]; });
+    }
+
+    /** How far, in dB, a band should currently be pulled down. */
+    SampleType getReductionDb (int band) const noexcept
+    {
+        const auto i = (size_t) band;
+
+        // 20 log10 (x) = 20 log10 (2) * log2 (x)
+        const auto levelDb = SampleType (6.020599913279624) * FastMath::log2 (std::max (envelope[i], envelopeFloor));
+        return std::clamp ((levelDb - threshold[i]) * slope[i], SampleType(), maxReductionDb);
+    }
+
+private:
+    template <typename Input>
+    void run (int numSamples, Input&& input) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = input (i);
+
+            for (size_t b = 0; b < (size_t) NumBands; ++b)
+            {
+                const auto v3 = x - ic2[b];
+                const auto v1 = a1[b] * ic1[b] + a2[b] * v3;
+                const auto v2 = ic2[b] + a2[b] * ic1[b] + a3[b] * v3;
+                ic1[b] = SampleType (2) * v1 - ic1[b];
+                ic2[b] = SampleType (2) * v2 - ic2[b];
+
+                const auto level = std::abs (m0[b] * x + m1[b] * v1 + m2[b] * v2);
+                envelope[b] = level + (level > envelope[b] ? attack : release) * (envelope[b] - level);
+            }
+        }
+    }
+
+    // Keeps log2 off denormals and zero in silence (-120 dB)
+    static constexpr SampleType envelopeFloor = SampleType (1.0e-6);
+
+    void designSidechain (int band) noexcept
+    {
+        const auto i = (size_t) band;
+        const auto K = FastMath::tanPi (juce::jmin (static_cast<SampleType> (frequency[i] / sampleRate), SampleType (0.49)));
+        const auto c = FilterDesign::makeSvfSidechainPrewarped (types[i], K, SampleType (1) / quality[i]);
+
+        a1[i] = c.a1;
+        a2[i] = c.a2;
+        a3[i] = c.a3;
+        m0[i] = c.m0;
+        m1[i] = c.m1;
+        m2[i] = c.m2;
+    }
+
+    static constexpr std::array<SampleType, (size_t) NumBands> makeFilled (SampleType value) noexcept
+    {
+        std::array<SampleType, (size_t) NumBands> a {};
+        a.fill (value);
+        return a;
+    }
+
+    double sampleRate { 44100.0 };
+    SampleType attack {}, release {};
+
+    std::array<BandType, (size_t) NumBands> types {};
+    std::array<SampleType, (size_t) NumBands> frequency = makeFilled (SampleType (1000));
+    std::array<SampleType, (size_t) NumBands> quality   = makeFilled (SampleType (1));
+
+    // Sidechain coefficients and state
+    alignas (16) std::array<SampleType, (size_t) NumBands> a1 {}, a2 {}, a3 {}, m0 {}, m1 {}, m2 {};
+    alignas (16) std::array<SampleType, (size_t) NumBands> ic1 {}, ic2 {}, envelope {};
+
+    // Gain computer
+    std::array<SampleType, (size_t) NumBands> threshold {};
+    std::array<SampleType, (size_t) NumBands> slope {};
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+
+//==============================================================================
+/** Normalised (a0 == 1) biquad coefficients, laid out the same way
+    juce::dsp::IIR stores them:
+
+        y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+*/
+template <typename SampleType>
+struct BiquadCoefficients
+{
+    SampleType b0 { 1 }, b1 {}, b2 {}, a1 {}, a2 {};
+
+    /** Builds a set from raw cookbook values { b0, b1, b2, a0, a1, a2 }. */
+    static BiquadCoefficients fromRaw (const std::array<SampleType, 6>& raw) noexcept
+    {
+        const auto a0inv = SampleType (1) / raw[3];
+        return { raw[0] * a0inv, raw[1] * a0inv, raw[2] * a0inv, raw[4] * a0inv, raw[5] * a0inv };
+    }
+
+    bool operator== (const BiquadCoefficients&) const = default;
+};
+
+//==============================================================================
+/**
+    A cascade of NumStages biquads that runs up to NumLanes channels side by
+    side, one channel per lane.
+
+    Coefficients and state are stored structure-of-arrays (one lane-wide row
+    per coefficient), so every stage boils down to a handful of multiply-adds
+    on NumLanes contiguous values — exactly one SSE/NEON register for the
+    default four float lanes, which the compiler vectorises without us having
+    to write intrinsics. All stages and the output gain are applied in a single
+    pass over the buffer.
+
+    Each lane has its own coefficients, so the same cascade can run linked
+    channels (set all lanes at once) or differently-tuned channels.
+*/
+template <typename SampleType, int NumStages, int NumLanes = 4>
+class BiquadCascade
+{
+public:
+    static constexpr int numStages = NumStages;
+    static constexpr int numLanes  = NumLanes;
+
+    using Coefficients = BiquadCoefficients<SampleType>;
+
+    BiquadCascade() noexcept
+    {
+        for (int stage = 0; stage < NumStages; ++stage)
+            setCoefficients (stage, Coefficients {});
+    }
+
+    /** Clears the filter state, leaving the coefficients untouched. */
+    void reset() noexcept
+    {
+        for (auto& s : stages)
+        {
+            std::fill (std::begin (s.z1), std::end (s.z1), SampleType());
+            std::fill (std::begin (s.z2), std::end (s.z2), SampleType());
+        }
+    }
+
+    /** Sets one stage's coefficients on every lane. */
+    void setCoefficients (int stage, const Coefficients& c) noexcept
+    {
+        for (int lane = 0; lane < NumLanes; ++lane)
+            setCoefficients (stage, lane, c);
+    }
+
+    /** Sets one stage's coefficients on a single lane. */
+    void setCoefficients (int stage, int lane, const Coefficients& c) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (stage, NumStages) && juce::isPositiveAndBelow (lane, NumLanes));
+
+        auto& s = stages[(size_t) stage];
+        s.b0[lane] = c.b0;
+        s.b1[lane] = c.b1;
+        s.b2[lane] = c.b2;
+        s.a1[lane] = c.a1;
+        s.a2[lane] = c.a2;
+    }
+
+    Coefficients getCoefficients (int stage, int lane) const noexcept
+    {
+        const auto& s = stages[(size_t) stage];
+        return { s.b0[lane], s.b1[lane], s.b2[lane], s.a1[lane], s.a2[lane] };
+    }
+
+    /** Filters numChannels (<= NumLanes) channels in place.
+
+        nextGain is called once per sample and its result multiplies every
+        channel of that sample, so a juce::SmoothedValue can be folded into
+        the filter loop instead of needing a second pass over the buffer.
+    */
+    template <typename GainSource>
+    void process (SampleType* const* channels, int numChannels, int numSamples, GainSource&& nextGain) noexcept
+    {
+        jassert (numChannels <= NumLanes);
+        run<false> (channels, numChannels, numSamples, nextGain);
+    }
+
+    /** Filters a stereo pair in place as mid and side: lane 0 runs
+        (L + R) / 2 and lane 1 (L - R) / 2, and the sum and difference come
+        back out as L and R. Encoding and decoding happen in the filter loop
+        itself, so this costs a few adds per sample over process().
+    */
+    template <typename GainSource>
+    void processMidSide (SampleType* const* channels, int numSamples, GainSource&& nextGain) noexcept
+    {
+        static_assert (NumLanes >= 2, "mid and side need a lane each");
+        run<true> (channels, 2, numSamples, nextGain);
+    }
+
+private:
+    template <bool MidSide, typename GainSource>
+    void run (SampleType* const* channels, int numChannels, int numSamples, GainSource&& nextGain) noexcept
+    {
+        // Work on a local copy: the compiler can't keep member state in
+        // registers because it might alias the channel data we write to.
+        auto local = stages;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            alignas (16) SampleType x[NumLanes] {};
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                x[ch] = channels[ch][i];
+
+            if constexpr (MidSide)
+            {
+                const auto left = x[0], right = x[1];
+                x[0] = SampleType (0.5) * (left + right);
+                x[1] = SampleType (0.5) * (left - right);
+            }
+
+            for (auto& s : local)
+            {
+                for (int lane = 0; lane < NumLanes; ++lane)
+                {
+                    const auto in  = x[lane];
+                    const auto out = s.b0[lane] * in + s.z1[lane];
+                    s.z1[lane] = s.b1[lane] * in - s.a1[lane] * out + s.z2[lane];
+                    s.z2[lane] = s.b2[lane] * in - s.a2[lane] * out;
+                    x[lane] = out;
+                }
+            }
+
+            const SampleType gain = nextGain();
+
+            if constexpr (MidSide)
+            {
+                channels[0][i] = (x[0] + x[1]) * gain;
+                channels[1][i] = (x[0] - x[1]) * gain;
+            }
+            else
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    channels[ch][i] = x[ch] * gain;
+            }
+        }
+
+        stages = local;
+    }
+
+    struct Stage
+    {
+        alignas (16) SampleType b0[NumLanes] {};
+        alignas (16) SampleType b1[NumLanes] {};
+        alignas (16) SampleType b2[NumLanes] {};
+        alignas (16) SampleType a1[NumLanes] {};
+        alignas (16) SampleType a2[NumLanes] {};
+        alignas (16) SampleType z1[NumLanes] {};
+        alignas (16) SampleType z2[NumLanes] {};
+    };
+
+    std::array<Stage, NumStages> stages;
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "FastMath.h"
+#include "FilterDesign.h"
+#include <vector>
+
+//==============================================================================
+/**
+    K = tan (pi f / fs) sampled on a log-frequency grid.
+
+    Positions are in table steps (pointsPerOctave per octave above minFrequency),
+    which is also the domain BandSmoother ramps frequency in, so a sweep moves
+    at a constant rate in octaves and a lookup is a single lerp.
+*/
+template <typename SampleType>
+class PrewarpTable
+{
+public:
+    static constexpr int pointsPerOctave = 64;
+    static constexpr double minFrequency = 10.0;
+
+    /** Allocates, so call from prepareToPlay. */
+    void prepare (double sampleRate)
+    {
+        // Stop just short of Nyquist, where tan() blows up.
+        const double maxFrequency = 0.49 * sampleRate;
+        const auto numPoints = (int) std::ceil (std::log2 (maxFrequency / minFrequency) * pointsPerOctave) + 2;
+
+        table.resize ((size_t) numPoints);
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const double freq = juce::jmin (maxFrequency, minFrequency * std::exp2 ((double) i / pointsPerOctave));
+            table[(size_t) i] = static_cast<SampleType> (std::tan (juce::MathConstants<double>::pi * freq / sampleRate));
+        }
+    }
+
+    SampleType positionForFrequency (SampleType freq) const noexcept
+    {
+        return std::log2 (freq / static_cast<SampleType> (minFrequency)) * static_cast<SampleType> (pointsPerOctave);
+    }
+
+    SampleType lookup (SampleType position) const noexcept
+    {
+        jassert (table.size() > 1);
+
+        const auto maxPosition = static_cast<SampleType> (table.size() - 1);
+        position = juce::jlimit (SampleType(), maxPosition, position);
+
+        const auto index = juce::jmin ((size_t) position, table.size() - 2);
+        const auto frac  = position - static_cast<SampleType> (index);
+        return table[index] + frac * (table[index + 1] - table[index]);
+    }
+
+private:
+    std::vector<SampleType> table;
+};
+
+//==============================================================================
+/**
+    Linearly ramps one band's design parameters towards a target over a fixed
+    number of control-rate steps.
+
+    The ramp runs in domains where linear interpolation is both cheap and keeps
+    the filter stable at every step: PrewarpTable position (log frequency),
+    s = 10^(dB / 80) for gain and 1/Q for bandwidth. Feed the current values to
+    FilterDesign::makeBandPrewarped() after each advance().
+*/
+template <typename SampleType>
+class BandSmoother
+{
+public:
+    struct Values
+    {
+        SampleType position {}, s { 1 }, invQ { 1 };
+    };
+
+    static Values toValues (const PrewarpTable<SampleType>& table, SampleType freq, SampleType gainDb, SampleType q) noexcept
+    {
+        // s = 10^(dB / 80), via exp2 to stay off std::pow on the audio thread
+        return { table.positionForFrequency (freq),
+                 FastMath::exp2 (gainDb * static_cast<SampleType> (3.321928094887362 / 80.0)),
+                 SampleType (1) / q };
+    }
+
+    /** Sets how many advance() calls a ramp takes. */
+    void setRampLength (int numSteps) noexcept
+    {
+        rampLength = juce::jmax (1, numSteps);
+    }
+
+    void setCurrentAndTarget (const Values& v) noexcept
+    {
+        current = target = v;
+        stepsRemaining = 0;
+    }
+
+    void setTarget (const Values& v) noexcept
+    {
+        target         = v;
+        stepsRemaining = rampLength;
+
+        const auto scale = SampleType (1) / static_cast<SampleType> (rampLength);
+        increment = { (target.position - current.position) * scale,
+                      (target.s - current.s) * scale,
+                      (target.invQ - current.invQ) * scale };
+    }
+
+    bool isSmoothing() const noexcept { return stepsRemaining > 0; }
+
+    /** Moves one control-rate step closer to the target, landing on it exactly. */
+    void advance() noexcept
+    {
+        if (stepsRemaining <= 0)
+            return;
+
+        if (--stepsRemaining == 0)
+        {
+            current = target;
+            return;
+        }
+
+        current.position += increment.position;
+        current.s        += increment.s;
+        current.invQ     += increment.invQ;
+    }
+
+    const Values& getCurrent() const noexcept { return current; }
+
+private:
+    Values current, target, increment;
+    int rampLength { 1 }, stepsRemaining { 0 };
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+
+//==============================================================================
+/**
+    Keyed gain reduction: follows the level of a sidechain (the key) and
+    ducks by however far it goes over a threshold, up to a range in dB.
+
+    The key is read in place, straight from the host's buffer. Each step of
+    stepSize samples costs one vectorised min/max scan per key channel, and
+    the envelope and gain computer run once per step on the step's peak, so
+    detection is a single pass over the key. Steps sit on a fixed grid
+    whatever lengths process() is called with.
+
+    The reduction a step works out applies over the next step. It can be
+    read with getReductionDb() to cut something else, such as a band, or
+    ramped across channels by process() itself.
+*/
+template <typename SampleType>
+class Ducker
+{
+public:
+    static constexpr int stepSize = 32;
+    static constexpr SampleType attackSeconds  = SampleType (0.005);
+    static constexpr SampleType releaseSeconds = SampleType (0.15);
+
+    void prepare (double sampleRate) noexcept
+    {
+        const auto stepsPerSecond = sampleRate / stepSize;
+        attack  = static_cast<SampleType> (std::exp (-1.0 / (attackSeconds * stepsPerSecond)));
+        release = static_cast<SampleType> (std::exp (-1.0 / (releaseSeconds * stepsPerSecond)));
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        peak = envelope = reductionDb = gainStep = SampleType();
+        gain = target = SampleType (1);
+        samplesUntilStep = stepSize;
+    }
+
+    /** Any time; takes effect at the next step. */
+    void setAmounts (SampleType newThresholdDb, SampleType newRangeDb) noexcept
+    {
+        thresholdDb = newThresholdDb;
+        rangeDb     = newRangeDb;
+    }
+
+    /** Samples left before the reduction next moves. */
+    int getSamplesUntilStep() const noexcept { return samplesUntilStep; }
+
+    /** How far, in dB, the key is asking for things to come down. */
+    SampleType getReductionDb() const noexcept { return reductionDb; }
+
+    /** Listens to numSamples of every key channel and multiplies channels,
+        which may be none, by the ducking gain over the same samples.
+    */
+    void process (const SampleType* const* key, int numKeyChannels,
+                  SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        for (int position = 0; position < numSamples;)
+        {
+            const int numToDo = juce::jmin (samplesUntilStep, numSamples - position);
+
+            for (int ch = 0; ch < numKeyChannels; ++ch)
+            {
+                const auto range = juce::FloatVectorOperations::findMinAndMax (key[ch] + position, numToDo);
+                peak = std::max ({ peak, -range.getStart(), range.getEnd() });
+            }
+
+            // A straight ramp within the step, so this vectorises too
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = channels[ch] + position;
+                for (int i = 0; i < numToDo; ++i)
+                    data[i] *= gain + gainStep * static_cast<SampleType> (i);
+            }
+
+            gain += gainStep * static_cast<SampleType> (numToDo);
+            position += numToDo;
+            samplesUntilStep -= numToDo;
+
+            if (samplesUntilStep == 0)
+                step();
+        }
+    }
+
+private:
+    void step() noexcept
+    {
+        envelope = peak + (peak > envelope ? attack : release) * (envelope - peak);
+        peak = SampleType();
+
+        const auto levelDb = juce::Decibels::gainToDecibels (envelope, SampleType (-120));
+        reductionDb = std::clamp (levelDb - thresholdDb, SampleType(), rangeDb);
+
+        // Land exactly on the last target, so the ramps don't drift
+        gain     = target;
+        target   = juce::Decibels::decibelsToGain (-reductionDb);
+        gainStep = (target - gain) / static_cast<SampleType> (stepSize);
+        samplesUntilStep = stepSize;
+    }
+
+    SampleType attack {}, release {};
+    SampleType thresholdDb { -30 }, rangeDb { 12 };
+
+    SampleType peak {}, envelope {}, reductionDb {};
+    SampleType gain { 1 }, target { 1 }, gainStep {};
+    int samplesUntilStep { stepSize };
+};
@@ -0,0 +1,479 @@
+#pragma once
+
+#include "BandDetector.h"
+#include "BiquadCascade.h"
+#include "CoefficientKernel.h"
+#include "CoefficientSmoother.h"
+#include "FilterDesign.h"
+#include "SvfCascade.h"
+#include <algorithm>
+
+//==============================================================================
+/** Filter topology policies for EqChain: which cascade runs the bands and how
+    their coefficients are designed from K, s and 1/Q.
+*/
+struct BiquadTopology
+{
+    template <typename T, int NumStages, int NumLanes>
+    using Cascade = BiquadCascade<T, NumStages, NumLanes>;
+
+    template <typename T>
+    static BiquadCoefficients<T> designPrewarped (BandType type, T K, T s, T invQ) noexcept
+    {
+        return FilterDesign::makeBandPrewarped (type, K, s, invQ);
+    }
+};
+
+/** Trapezoidal state-variable filters. Same responses as BiquadTopology, but
+    they hold their precision in float at low cutoffs and high sample rates
+    and are better behaved while coefficients are moving.
+*/
+struct SvfTopology
+{
+    template <typename T, int NumStages, int NumLanes>
+    using Cascade = SvfCascade<T, NumStages, NumLanes>;
+
+    template <typename T>
+    static SvfCoefficients<T> designPrewarped (BandType type, T K, T s, T invQ) noexcept
+    {
+        return FilterDesign::makeSvfBandPrewarped (type, K, s, invQ);
+    }
+};
+
+/** How EqChain lays its two sets of bands over a stereo pair. */
+enum class StereoMode
+{
+    Linked,    // The first set on every channel
+    MidSide,   // The first set on mid, the second on side
+    LeftRight  // The first set on left, the second on right
+};
+
+//==============================================================================
+/**
+    A fixed series of EQ bands over up to MaxChannels channels, with smoothed
+    parameter changes.
+
+    Channels run NumLanes at a time, one per SIMD lane of a cascade, so the
+    filter state is structure-of-arrays across channels and a 7.1.4 bus costs
+    three cascades rather than twelve. With more than one group in use, the
+    gain is pulled once per sample into a scratch buffer and every group
+    replays it.
+
+    There are two sets of bands. Indices below NumBands address the first,
+    which is all that Linked mode uses, on every channel. The split stereo
+    modes (setStereoMode) take exactly two channels and put the second set,
+    indices NumBands and up, on lane 1 of the cascade; for MidSide the encode
+    and decode are folded into the cascade's own loop, so no mode costs an
+    extra pass over the buffer.
+
+    Bands set with rampBand() glide to their new settings over the smoothing
+    time: while any band is ramping, coefficients are recomputed every
+    smoothingInterval samples from the PrewarpTable, and the full-accuracy
+    design takes over once the ramp lands. snapBand() jumps straight there.
+    Either way only the bands that changed are redesigned, in one
+    CoefficientKernel batch at the start of the next process() call or
+    smoothing step. Nothing here allocates after prepare().
+
+    Any band can also be made dynamic with setDynamics(): each set's
+    BandDetector listens to that set's share of the input, and on the same control-rate grid the
+    band's gain is pulled down by the detector's gain reduction, through the
+    kernel like any other change. Bands whose reduction hasn't moved since
+    the last step are left alone.
+
+    A band can be keyed from outside too (setKeyed): the owner hands it a
+    reduction, e.g. from a sidechain, with setKeyReductionDb(), and it is
+    added to the band's own on that grid.
+*/
+template <typename SampleType, typename Topology, int NumBands, int NumLanes = 4, int MaxChannels = NumLanes>
+class EqChain
+{
+public:
+    using Cascade = typename Topology::template Cascade<SampleType, NumBands, NumLanes>;
+
+    static constexpr int numBands    = NumBands;
+    static constexpr int numLanes    = NumLanes;
+    static constexpr int maxChannels = MaxChannels;
+    static constexpr int numGroups   = (MaxChannels + NumLanes - 1) / NumLanes;
+    static constexpr int numChannelSets = 2;
+    // Control-rate step for both ramps and dynamic bands
+    static constexpr int smoothingInterval = 32;
+
+    explicit EqChain (const std::array<BandType, (size_t) NumBands>& types) noexcept
+        : bandTypes (types)
+    {
+    }
+
+    /** Allocates, so call from prepareToPlay. maxSampleRate is the highest
+        rate setSampleRate() will be asked for, e.g. when oversampling: a
+        PrewarpTable is filled here for newSampleRate and each doubling of it
+        up to there.
+    */
+    void prepare (double newSampleRate, double smoothingSeconds = 0.02, double maxSampleRate = 0.0)
+    {
+        smoothingTime = smoothingSeconds;
+        baseSampleRate = newSampleRate;
+        prewarpTables.clear();
+
+        for (double rate = newSampleRate; prewarpTables.empty() || rate <= maxSampleRate; rate *= 2.0)
+            prewarpTables.emplace_back().prepare (rate);
+
+        setSampleRate (newSampleRate);
+    }
+
+    /** Moves to prepare()'s rate or one of its doublings, picking up the
+        table already filled for it. Doesn't allocate. Clears the filter
+        state; snap every band afterwards.
+    */
+    void setSampleRate (double newSampleRate) noexcept
+    {
+        size_t doublings = 0;
+        while (doublings + 1 < prewarpTables.size() && baseSampleRate * (double) (2 << doublings) <= newSampleRate)
+            ++doublings;
+
+        jassert (juce::approximatelyEqual (newSampleRate, baseSampleRate * (double) (1 << doublings)));
+
+        sampleRate = newSampleRate;
+        prewarpTable = &prewarpTables[doublings];
+
+        for (auto& band : bands)
+            band.smoother.setRampLength (juce::roundToInt (smoothingTime * sampleRate / smoothingInterval));
+
+        for (auto& detector : detectors)
+            detector.setSampleRate (sampleRate);
+
+        reset();
+    }
+
+    /** Clears the filter state, leaving the settings untouched. */
+    void reset() noexcept
+    {
+        for (auto& group : cascades.groups)
+            group.reset();
+
+        for (auto& detector : detectors)
+            detector.reset();
+
+        samplesUntilSmoothingStep = 0;
+    }
+
+    /** Switches how the two sets of bands map onto the channels. Clears the
+        filter state and redesigns every band from its settings.
+    */
+    void setStereoMode (StereoMode newMode) noexcept
+    {
+        if (newMode == stereoMode)
+            return;
+
+        stereoMode = newMode;
+        cascades.stereoMode = newMode;
+        reset();
+
+        // Lanes may now belong to the other set, so none of them can be trusted
+        for (int index = 0; index < numBandsInUse(); ++index)
+        {
+            auto& band = bands[(size_t) index];
+            const auto& s = band.settings;
+            band.reductionDb = SampleType();
+            kernelFor (index).setBand (index % NumBands, s.freq, s.gainDb, s.q);
+        }
+    }
+
+    StereoMode getStereoMode() const noexcept { return stereoMode; }
+
+    /** Moves a band to new settings immediately. */
+    void snapBand (int index, SampleType freq, SampleType gainDb, SampleType q) noexcept
+    {
+        auto& band = bands[(size_t) index];
+        band.settings = { freq, gainDb, q };
+        band.smoother.setCurrentAndTarget (BandSmoother<SampleType>::toValues (*prewarpTable, freq, gainDb, q));
+        band.reductionDb = SampleType();
+        kernelFor (index).setBand (index % NumBands, freq, gainDb, q);
+        detectorFor (index).setBand (index % NumBands, bandTypes[(size_t) (index % NumBands)], freq, q);
+    }
+
+    /** Starts a band ramping towards new settings. The first step is taken
+        before the next sample is processed.
+    */
+    void rampBand (int index, SampleType freq, SampleType gainDb, SampleType q) noexcept
+    {
+        auto& band = bands[(size_t) index];
+        band.settings = { freq, gainDb, q };
+        band.smoother.setTarget (BandSmoother<SampleType>::toValues (*prewarpTable, freq, gainDb, q));
+        detectorFor (index).setBand (index % NumBands, bandTypes[(size_t) (index % NumBands)], freq, q);
+        samplesUntilSmoothingStep = 0;
+    }
+
+    /** Makes a band follow its detector, or static again. A band that stops
+        being dynamic goes straight back to its set gain.
+    */
+    void setDynamics (int index, bool enabled, SampleType thresholdDb, SampleType ratio) noexcept
+    {
+        auto& band = bands[(size_t) index];
+        detectorFor (index).setThreshold (index % NumBands, thresholdDb, ratio);
+
+        if (band.dynamic == enabled)
+            return;
+
+        band.dynamic = enabled;
+        band.reductionDb = SampleType();
+
+        if (! band.smoother.isSmoothing())
+            kernelFor (index).setBand (index % NumBands, band.settings.freq, band.settings.gainDb, band.settings.q);
+    }
+
+    /** Lets a band be cut from outside, on top of any dynamics. A band that
+        stops being keyed goes straight back to its set gain.
+    */
+    void setKeyed (int index, bool enabled) noexcept
+    {
+        auto& band = bands[(size_t) index];
+        if (band.keyed == enabled)
+            return;
+
+        band.keyed = enabled;
+        band.keyReductionDb = SampleType();
+        band.reductionDb = SampleType();
+
+        if (! band.smoother.isSmoothing())
+            kernelFor (index).setBand (index % NumBands, band.settings.freq, band.settings.gainDb, band.settings.q);
+    }
+
+    /** The outside cut for a keyed band, picked up at the next control step. */
+    void setKeyReductionDb (int index, SampleType reductionDb) noexcept
+    {
+        auto& band = bands[(size_t) index];
+        if (band.keyed)
+            band.keyReductionDb = reductionDb;
+    }
+
+    bool isSmoothing() const noexcept
+    {
+        return std::any_of (bands.begin(), bands.begin() + numBandsInUse(), [] (const auto& b) { return b.smoother.isSmoothing(); });
+    }
+
+    bool isDynamic() const noexcept
+    {
+        return std::any_of (bands.begin(), bands.begin() + numBandsInUse(), [] (const auto& b) { return b.dynamic; });
+    }
+
+    bool isKeyed() const noexcept
+    {
+        return std::any_of (bands.begin(), bands.begin() + numBandsInUse(), [] (const auto& b) { return b.keyed; });
+    }
+
+    /** Band coefficient sets designed since construction, both sets together. */
+    juce::uint64 getNumDesigned() const noexcept
+    {
+        juce::uint64 total = 0;
+        for (const auto& kernel : kernels)
+            total += kernel.getNumDesigned();
+        return total;
+    }
+
+    /** The gain reduction a dynamic band had at the last control step. */
+    SampleType getReductionDb (int index) const noexcept
+    {
+        return bands[(size_t) index].reductionDb;
+    }
+
+    /** Filters numChannels (<= MaxChannels) channels in place through every
+        band, multiplying each sample by nextGain() in the same pass. The
+        split stereo modes need numChannels == 2.
+    */
+    template <typename GainSource>
+    void process (SampleType* const* channels, int numChannels, int numSamples, GainSource&& nextGain) noexcept
+    {
+        jassert (numChannels <= MaxChannels);
+        jassert (stereoMode == StereoMode::Linked || numChannels == 2);
+
+        updateKernels();
+
+        const bool dynamic = isDynamic();
+        const bool keyed   = isKeyed();
+        const int numGroupsInUse = (numChannels + NumLanes - 1) / NumLanes;
+        std::array<SampleType*, (size_t) MaxChannels> chunk {};
+        int position = 0;
+
+        while (position < numSamples)
+        {
+            int numToDo = numSamples - position;
+
+            if (numGroupsInUse > 1)
+                numToDo = juce::jmin (numToDo, gainChunkSize);
+
+            // Ramping, dynamic and keyed bands move on a fixed control-rate grid
+            if (dynamic || keyed || isSmoothing())
+            {
+                if (samplesUntilSmoothingStep == 0)
+                {
+                    stepControl();
+                    samplesUntilSmoothingStep = smoothingInterval;
+                }
+
+                numToDo = juce::jmin (numToDo, samplesUntilSmoothingStep);
+                samplesUntilSmoothingStep -= numToDo;
+            }
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                chunk[(size_t) ch] = channels[ch] + position;
+
+            // The detectors hear the input, so they run before the cascade
+            // overwrites it; the next control step acts on what they heard.
+            if (dynamic)
+                runDetectors (chunk.data(), numChannels, numToDo);
+
+            if (stereoMode == StereoMode::MidSide)
+            {
+                cascades.groups[0].processMidSide (chunk.data(), numToDo, nextGain);
+            }
+            else if (numGroupsInUse == 1)
+            {
+                cascades.groups[0].process (chunk.data(), numChannels, numToDo, nextGain);
+            }
+            else
+            {
+                for (int i = 0; i < numToDo; ++i)
+                    gains[(size_t) i] = nextGain();
+
+                for (int group = 0; group < numGroupsInUse; ++group)
+                {
+                    const int first = group * NumLanes;
+                    int i = 0;
+                    cascades.groups[(size_t) group].process (chunk.data() + first, juce::jmin (NumLanes, numChannels - first), numToDo,
+                                                             [this, &i] { return gains[(size_t) i++]; });
+                }
+            }
+            position += numToDo;
+        }
+    }
+
+private:
+    struct Settings
+    {
+        SampleType freq {}, gainDb {}, q { 1 };
+    };
+
+    struct Band
+    {
+        Settings settings;
+        BandSmoother<SampleType> smoother;
+        bool dynamic { false }, keyed { false };
+        SampleType reductionDb {}, keyReductionDb {};
+    };
+
+    int numBandsInUse() const noexcept
+    {
+        return stereoMode == StereoMode::Linked ? NumBands : NumBands * numChannelSets;
+    }
+
+    CoefficientKernel<SampleType, NumBands>& kernelFor (int index) noexcept { return kernels[(size_t) (index / NumBands)]; }
+    BandDetector<SampleType, NumBands>& detectorFor (int index) noexcept    { return detectors[(size_t) (index / NumBands)]; }
+
+    void updateKernels() noexcept
+    {
+        for (int set = 0; set < numBandsInUse() / NumBands; ++set)
+        {
+            typename Cascades::SetTarget target { cascades, set };
+            kernels[(size_t) set].template update<Topology> (bandTypes, sampleRate, target);
+        }
+    }
+
+    // Each set's detectors hear the signal that set's bands will filter
+    void runDetectors (const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        switch (stereoMode)
+        {
+            case StereoMode::Linked:
+                detectors[0].process (channels, numChannels, numSamples);
+                break;
+
+            case StereoMode::MidSide:
+                detectors[0].processStereo (channels, SampleType (0.5), SampleType (0.5), numSamples);
+                detectors[1].processStereo (channels, SampleType (0.5), SampleType (-0.5), numSamples);
+                break;
+
+            case StereoMode::LeftRight:
+                detectors[0].processStereo (channels, SampleType (1), SampleType(), numSamples);
+                detectors[1].processStereo (channels, SampleType(), SampleType (1), numSamples);
+                break;
+        }
+    }
+
+    void stepControl() noexcept
+    {
+        for (int index = 0; index < numBandsInUse(); ++index)
+        {
+            auto& band = bands[(size_t) index];
+            const bool ramping = band.smoother.isSmoothing();
+
+            const auto reductionDb = (band.dynamic ? detectorFor (index).getReductionDb (index % NumBands) : SampleType())
+                                   + band.keyReductionDb;
+            const bool reductionMoved = reductionDb != band.reductionDb;
+            band.reductionDb = reductionDb;
+
+            if (! ramping && ! reductionMoved)
+                continue;
+
+            band.smoother.advance();
+
+            if (band.smoother.isSmoothing())
+            {
+                // s = 10^(dB / 80), so a cut of r dB scales it by 2^(-r log2 (10) / 80)
+                const auto& v = band.smoother.getCurrent();
+                const auto cut = FastMath::exp2 (-reductionDb * static_cast<SampleType> (3.321928094887362 / 80.0));
+                kernelFor (index).setBandPrewarped (index % NumBands, prewarpTable->lookup (v.position), v.s * cut, v.invQ);
+            }
+            else
+            {
+                // Landed: design from the settings so static bands are unaffected by the table
+                const auto& s = band.settings;
+                kernelFor (index).setBand (index % NumBands, s.freq, s.gainDb - reductionDb, s.q);
+            }
+        }
+
+        updateKernels();
+    }
+
+    // Every group of lanes. Linked, the first set's coefficients go to every
+    // lane; split, each set owns one lane of the first group.
+    struct Cascades
+    {
+        std::array<Cascade, (size_t) numGroups> groups;
+        StereoMode stereoMode { StereoMode::Linked };
+
+        // What a set's CoefficientKernel designs into
+        struct SetTarget
+        {
+            Cascades& cascades;
+            int set;
+
+            template <typename Coefficients>
+            void setCoefficients (int stage, const Coefficients& c) noexcept
+            {
+                if (cascades.stereoMode == StereoMode::Linked)
+                {
+                    for (auto& group : cascades.groups)
+                        group.setCoefficients (stage, c);
+                }
+                else
+                {
+                    cascades.groups[0].setCoefficients (stage, set, c);
+                }
+            }
+        };
+    };
+
+    static constexpr int gainChunkSize = 256;
+
+    std::array<BandType, (size_t) NumBands> bandTypes;
+    std::array<Band, (size_t) (NumBands * numChannelSets)> bands;
+    Cascades cascades;
+    std::array<SampleType, (size_t) gainChunkSize> gains {};
+    std::array<CoefficientKernel<SampleType, NumBands>, (size_t) numChannelSets> kernels;
+    std::array<BandDetector<SampleType, NumBands>, (size_t) numChannelSets> detectors;
+    StereoMode stereoMode { StereoMode::Linked };
+    std::vector<PrewarpTable<SampleType>> prewarpTables;
+    const PrewarpTable<SampleType>* prewarpTable {};
+    double sampleRate { 44100.0 }, baseSampleRate { 44100.0 }, smoothingTime { 0.02 };
+    int samplesUntilSmoothingStep { 0 };
+};
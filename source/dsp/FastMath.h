@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+//==============================================================================
+/**
+    Branch-free polynomial replacements for the transcendental functions on
+    the coefficient path. They are plain arithmetic plus selects, so a loop
+    over an array of inputs vectorises.
+
+    The polynomials are Cephes' tanf and exp2f minimax fits. Their own error
+    is quoted for double; in float, rounding dominates and both functions are
+    within a few ulp.
+*/
+namespace FastMath
+{
+    /** tan (pi x) for x in [0, 0.5). Max relative error 2e-8 (2e-7 in float).
+
+        Folds x > 0.25 onto tan (pi x) = 1 / tan (pi (0.5 - x)), so the
+        polynomial only ever sees angles up to pi / 4.
+    */
+    template <typename T>
+    T tanPi (T x) noexcept
+    {
+        const bool upper = x > T (0.25);
+        const T theta    = juce::MathConstants<T>::pi * (upper ? T (0.5) - x : x);
+        const T z        = theta * theta;
+
+        const T t = (((((T (9.38540185543e-3) * z + T (3.11992232697e-3)) * z
+                         + T (2.44301354525e-2)) * z
+                         + T (5.34112807005e-2)) * z
+                         + T (1.33387994085e-1)) * z
+                         + T (3.33331568548e-1)) * z * theta + theta;
+
+        return upper ? T (1) / t : t;
+    }
+
+    /** 2^x for |x| < 126 (float) or 1022 (double). Max relative error 2e-9
+        (1e-7 in float).
+    */
+    template <typename T>
+    T exp2 (T x) noexcept
+    {
+        using Bits = std::conditional_t<std::is_same_v<T, float>, std::int32_t, std::int64_t>;
+        constexpr int mantissaBits = std::numeric_limits<T>::digits - 1;
+        constexpr int exponentBias = std::numeric_limits<T>::max_exponent - 1;
+
+        // 2^x = 2^n * 2^f, with n the nearest integer and f in [-0.5, 0.5]
+        const T n = std::floor (x + T (0.5));
+        const T f = x - n;
+
+        const T p = (((((T (1.535336188319500e-4) * f + T (1.339887440266574e-3)) * f
+                          + T (9.618437357674640e-3)) * f
+                          + T (5.550332471162809e-2)) * f
+                          + T (2.402264791363012e-1)) * f
+                          + T (6.931472028550421e-1)) * f + T (1);
+
+        const auto scale = std::bit_cast<T> (static_cast<Bits> (static_cast<Bits> (n) + exponentBias) << mantissaBits);
+        return p * scale;
+    }
+
+    /** log2 (x) for normal, positive x. Max absolute error 2e-5.
+
+        Splits off the exponent bits and runs the atanh series on the
+        mantissa m in [1, 2): log2 (m) = 2 / ln 2 * atanh ((m - 1) / (m + 1)).
+    */
+    template <typename T>
+    T log2 (T x) noexcept
+    {
+        using Bits = std::conditional_t<std::is_same_v<T, float>, std::int32_t, std::int64_t>;
+        constexpr int mantissaBits = std::numeric_limits<T>::digits - 1;
+        constexpr int exponentBias = std::numeric_limits<T>::max_exponent - 1;
+        constexpr Bits mantissaMask = (Bits (1) << mantissaBits) - 1;
+
+        const auto bits = std::bit_cast<Bits> (x);
+        const auto e    = static_cast<T> ((bits >> mantissaBits) - exponentBias);
+        const auto m    = std::bit_cast<T> ((bits & mantissaMask) | (static_cast<Bits> (exponentBias) << mantissaBits));
+
+        const T z  = (m - T (1)) / (m + T (1));
+        const T z2 = z * z;
+        const T series = z * (T (1) + z2 * (T (1) / T (3) + z2 * (T (1) / T (5) + z2 * T (1) / T (7))));
+
+        return e + T (2.885390081777927) * series;
+    }
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "BiquadCascade.h"
+#include "SvfCascade.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/** The three band shapes MojoPunch offers. */
+enum class BandType
+{
+    LowShelf,
+    PeakBell,
+    HighShelf
+};
+
+//==============================================================================
+/**
+    RBJ Audio-EQ-Cookbook designs for the EQ bands, for both the direct-form
+    biquad and the state-variable topology.
+
+    The plain make* functions are the reference formulas: exact trig and pow
+    on every call, so they belong in places that run when a parameter
+    changes, not per sample.
+*/
+struct FilterDesign
+{
+    template <typename T>
+    static BiquadCoefficients<T> makeLowShelf (double sampleRate, T freq, T gainDb, T q) noexcept
+    {
+        const T A     = std::sqrt (juce::Decibels::decibelsToGain (gainDb));
+        const T omega = juce::MathConstants<T>::twoPi * freq / static_cast<T> (sampleRate);
+        const T cosW  = std::cos (omega);
+        const T sinW  = std::sin (omega);
+        const T beta  = sinW * std::sqrt (A) / q;
+
+        return BiquadCoefficients<T>::fromRaw ({ {
+            A * (A + T (1) - (A - T (1)) * cosW + beta),
+            T (2) * A * (A - T (1) - (A + T (1)) * cosW),
+            A * (A + T (1) - (A - T (1)) * cosW - beta),
+            A + T (1) + (A - T (1)) * cosW + beta,
+            T (-2) * (A - T (1) + (A + T (1)) * cosW),
+            A + T (1) + (A - T (1)) * cosW - beta } });
+    }
+
+    template <typename T>
+    static BiquadCoefficients<T> makePeakBell (double sampleRate, T freq, T gainDb, T q) noexcept
+    {
+        const T A     = std::sqrt (juce::Decibels::decibelsToGain (gainDb));
+        const T omega = juce::MathConstants<T>::twoPi * freq / static_cast<T> (sampleRate);
+        const T cosW  = std::cos (omega);
+        const T sinW  = std::sin (omega);
+        const T alpha = sinW / (T (2) * q);
+
+        return BiquadCoefficients<T>::fromRaw ({ {
+            T (1) + alpha * A,
+            T (-2) * cosW,
+            T (1) - alpha * A,
+            T (1) + alpha / A,
+            T (-2) * cosW,
+            T (1) - alpha / A } });
+    }
+
+    template <typename T>
+    static BiquadCoefficients<T> makeHighShelf (double sampleRate, T freq, T gainDb, T q) noexcept
+    {
+        const T A     = std::sqrt (juce::Decibels::decibelsToGain (gainDb));
+        const T omega = juce::MathConstants<T>::twoPi * freq / static_cast<T> (sampleRate);
+        const T cosW  = std::cos (omega);
+        const T sinW  = std::sin (omega);
+        const T beta  = sinW * std::sqrt (A) / q;
+
+        return BiquadCoefficients<T>::fromRaw ({ {
+            A * (A + T (1) + (A - T (1)) * cosW + beta),
+            T (-2) * A * (A - T (1) + (A + T (1)) * cosW),
+            A * (A + T (1) + (A - T (1)) * cosW - beta),
+            A + T (1) - (A - T (1)) * cosW + beta,
+            T (2) * (A - T (1) - (A + T (1)) * cosW),
+            A + T (1) - (A - T (1)) * cosW - beta } });
+    }
+
+    template <typename T>
+    static BiquadCoefficients<T> makeBand (BandType type, double sampleRate, T freq, T gainDb, T q) noexcept
+    {
+        switch (type)
+        {
+            case BandType::LowShelf:  return makeLowShelf  (sampleRate, freq, gainDb, q);
+            case BandType::PeakBell:  return makePeakBell  (sampleRate, freq, gainDb, q);
+            case BandType::HighShelf: return makeHighShelf (sampleRate, freq, gainDb, q);
+        }
+
+        jassertfalse;
+        return {};
+    }
+
+    //==============================================================================
+    /** The same three designs, rewritten in terms of the pre-warped frequency
+        K = tan (pi f / fs), with sin(w) = 2K / (1 + K^2) and
+        cos(w) = (1 - K^2) / (1 + K^2) substituted and the common (1 + K^2)
+        factor cancelled.
+
+        With K coming from a table and gain given as s = 10^(dB / 80) (so the
+        cookbook's A is s * s), this needs no trig, pow or sqrt and at most two
+        divides per band, which makes it cheap enough to rerun every few
+        samples while a parameter is moving.
+    */
+    template <typename T>
+    static BiquadCoefficients<T> makeBandPrewarped (BandType type, T K, T s, T invQ) noexcept
+    {
+        const T A  = s * s;
+        const T K2 = K * K;
+
+        switch (type)
+        {
+            case BandType::LowShelf:
+            {
+                const T beta = K * s * invQ;
+                return BiquadCoefficients<T>::fromRaw ({ {
+                    A * (A * K2 + T (1) + beta),
+                    T (2) * A * (A * K2 - T (1)),
+                    A * (A * K2 + T (1) - beta),
+                    A + K2 + beta,
+                    T (-2) * (A - K2),
+                    A + K2 - beta } });
+            }
+
+            case BandType::PeakBell:
+            {
+                const T alpha = K * invQ;
+                return BiquadCoefficients<T>::fromRaw ({ {
+                    T (1) + K2 + alpha * A,
+                    T (-2) * (T (1) - K2),
+                    T (1) + K2 - alpha * A,
+                    T (1) + K2 + alpha / A,
+                    T (-2) * (T (1) - K2),
+                    T (1) + K2 - alpha / A } });
+            }
+
+            case BandType::HighShelf:
+            {
+                const T beta = K * s * invQ;
+                return BiquadCoefficients<T>::fromRaw ({ {
+                    A * (A + K2 + beta),
+                    T (-2) * A * (A - K2),
+                    A * (A + K2 - beta),
+                    A * K2 + T (1) + beta,
+                    T (2) * (A * K2 - T (1)),
+                    A * K2 + T (1) - beta } });
+            }
+        }
+
+        jassertfalse;
+        return {};
+    }
+
+    //==============================================================================
+    /** SVF versions of the same three responses (Simper's shelf and bell mixes),
+        taking the same K, s = 10^(dB / 80) and 1/Q as makeBandPrewarped. The
+        transfer functions match the cookbook biquads.
+    */
+    template <typename T>
+    static SvfCoefficients<T> makeSvfBandPrewarped (BandType type, T K, T s, T invQ) noexcept
+    {
+        const T A = s * s;
+
+        switch (type)
+        {
+            case BandType::LowShelf:  return SvfCoefficients<T>::fromGK (K / s, invQ, T (1), invQ * (A - T (1)), A * A - T (1));
+            case BandType::PeakBell:  return SvfCoefficients<T>::fromGK (K, invQ / A, T (1), invQ / A * (A * A - T (1)), T (0));
+            case BandType::HighShelf: return SvfCoefficients<T>::fromGK (K * s, invQ, A * A, invQ * (T (1) - A) * A, T (1) - A * A);
+        }
+
+        jassertfalse;
+        return {};
+    }
+
+    /** The sidechain a dynamic band listens to: a low-pass under a low shelf,
+        a unity-peak band-pass around a bell and a high-pass over a high shelf,
+        all at the band's own frequency and Q.
+    */
+    template <typename T>
+    static SvfCoefficients<T> makeSvfSidechainPrewarped (BandType type, T K, T invQ) noexcept
+    {
+        switch (type)
+        {
+            case BandType::LowShelf:  return SvfCoefficients<T>::fromGK (K, invQ, T (0), T (0), T (1));
+            case BandType::PeakBell:  return SvfCoefficients<T>::fromGK (K, invQ, T (0), invQ, T (0));
+            case BandType::HighShelf: return SvfCoefficients<T>::fromGK (K, invQ, T (1), -invQ, T (-1));
+        }
+
+        jassertfalse;
+        return {};
+    }
+
+    template <typename T>
+    static SvfCoefficients<T> makeSvfBand (BandType type, double sampleRate, T freq, T gainDb, T q) noexcept
+    {
+        const T K = std::tan (juce::MathConstants<T>::pi * freq / static_cast<T> (sampleRate));
+        return makeSvfBandPrewarped (type, K, std::pow (T (10), gainDb / T (80)), T (1) / q);
+    }
+
+    //==============================================================================
+    /** How long a band's impulse response takes to fall by decayDb, from the
+        slower pole of its analog prototype. Shelves move their poles to
+        f / sqrt (A) (low) or f sqrt (A) (high) at the set Q; a bell keeps f
+        and has pole Q = A Q. A flat band is a wire and has no tail.
+    */
+    static double decaySeconds (BandType type, double freq, double gainDb, double q, double decayDb) noexcept
+    {
+        if (gainDb == 0.0)
+            return 0.0;
+
+        const double A = std::pow (10.0, gainDb / 40.0);
+        double poleFreq = freq, poleQ = q;
+
+        switch (type)
+        {
+            case BandType::LowShelf:  poleFreq = freq / std::sqrt (A); break;
+            case BandType::PeakBell:  poleQ    = q * A;                break;
+            case BandType::HighShelf: poleFreq = freq * std::sqrt (A); break;
+        }
+
+        // Decay rate of the slower pole: w / 2Q for a complex pair, the
+        // smaller real root once Q drops below 0.5
+        const double damping = 0.5 / poleQ;
+        const double rate    = juce::MathConstants<double>::twoPi * poleFreq
+                             * (damping - std::sqrt (juce::jmax (0.0, damping * damping - 1.0)));
+
+        return decayDb * std::log (10.0) / 20.0 / rate;
+    }
+};
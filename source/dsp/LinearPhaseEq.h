@@ -0,0 +1,483 @@
+#pragma once
+
+#include "FilterDesign.h"
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <complex>
+#include <vector>
+
+//==============================================================================
+/**
+    A linear-phase version of a series of EQ bands, run as uniformly
+    partitioned FFT convolution.
+
+    The FIR is designed from the magnitude response of the same cookbook
+    biquads the minimum-phase chain uses, made zero-phase, centred and
+    windowed, so it has the same curve with a constant delay of half its
+    length. It is then split into partitionSize blocks, each transformed
+    once, and convolved against a frequency-domain delay line of the input
+    (overlap-save). Every partitionSize samples costs one forward FFT, one
+    pass of complex multiply-adds per partition and one inverse FFT per
+    channel, whatever the host block size, so cost per sample stays flat.
+
+    Kernels are rebuilt on a background thread. The audio thread only posts
+    the curve it wants through atomics, and picks up finished kernels from a
+    set of three preallocated slots, crossfading from the old kernel to the
+    new one over one partition. Neither side ever waits for the other.
+*/
+template <int NumBands>
+class LinearPhaseEq
+{
+public:
+    struct Band
+    {
+        float freq {}, gainDb {}, q { 1.0f };
+        bool operator== (const Band&) const = default;
+    };
+
+    using Curve = std::array<Band, (size_t) NumBands>;
+
+    static constexpr int partitionSize = 256;
+
+    explicit LinearPhaseEq (const std::array<BandType, (size_t) NumBands>& types)
+        : bandTypes (types)
+    {
+    }
+
+    ~LinearPhaseEq()
+    {
+        release();
+    }
+
+    /** Allocates everything, designs the first kernel for curve on the calling
+        thread and starts the background builder. Call from prepareToPlay.
+
+        designSampleRate is the rate the biquads being matched run at, which
+        is higher than sampleRate when they would be oversampled.
+    */
+    void prepare (double newSampleRate, double designSampleRate, int numChannels, const Curve& curve)
+    {
+        release();
+
+        sampleRate    = newSampleRate;
+        kernelLength  = juce::nextPowerOfTwo (juce::roundToInt (sampleRate * kernelSeconds));
+        numPartitions = kernelLength / partitionSize;
+
+        designFFT = std::make_unique<juce::dsp::FFT> (juce::roundToInt (std::log2 (kernelLength)));
+        designBuffer.assign ((size_t) kernelLength * 2, 0.0f);
+        impulse.assign ((size_t) kernelLength, 0.0f);
+
+        // Blackman, peaking on the centre tap
+        window.resize ((size_t) kernelLength);
+        for (size_t n = 0; n < window.size(); ++n)
+        {
+            const auto phase = juce::MathConstants<double>::twoPi * (double) n / kernelLength;
+            window[n] = (float) (0.42 - 0.5 * std::cos (phase) + 0.08 * std::cos (2.0 * phase));
+        }
+
+        for (auto& k : kernels)
+        {
+            k.re.assign ((size_t) (numPartitions * numBins), 0.0f);
+            k.im.assign ((size_t) (numPartitions * numBins), 0.0f);
+        }
+
+        channelStates.resize ((size_t) numChannels);
+        for (auto& c : channelStates)
+        {
+            c.input.assign ((size_t) partitionSize * 2, 0.0f);
+            c.output.assign ((size_t) partitionSize, 0.0f);
+            c.spectraRe.assign ((size_t) (numPartitions * numBins), 0.0f);
+            c.spectraIm.assign ((size_t) (numPartitions * numBins), 0.0f);
+        }
+
+        fftBuffer.assign ((size_t) fftSize * 2, 0.0f);
+        accumulatorRe.assign ((size_t) numBins, 0.0f);
+        accumulatorIm.assign ((size_t) numBins, 0.0f);
+        fadeBuffer.assign ((size_t) partitionSize, 0.0f);
+
+        lastRequestRate = 0.0;
+        requestCurve (curve, designSampleRate);
+        const auto version = requestVersion.load();
+        designKernel (curve, designSampleRate, kernels[0]);
+        kernelVersions[0] = version;
+        builtVersion      = version;
+        activeVersion     = version;
+        slotState         = Slots { 0, 0, Slots::none }.pack();
+
+        reset();
+        builder.startThread();
+    }
+
+    /** Stops the background builder and frees what prepare() allocated, so
+        an idle instance costs no thread and almost no memory.
+    */
+    void release()
+    {
+        builder.stopThread (1000);
+
+        designFFT.reset();
+        designBuffer = {};
+        impulse      = {};
+        window       = {};
+
+        for (auto& k : kernels)
+            k = {};
+
+        channelStates = {};
+        fftBuffer     = {};
+        accumulatorRe = {};
+        accumulatorIm = {};
+        fadeBuffer    = {};
+    }
+
+    /** Clears the delay lines, leaving the kernel alone. */
+    void reset() noexcept
+    {
+        for (auto& c : channelStates)
+        {
+            std::fill (c.input.begin(), c.input.end(), 0.0f);
+            std::fill (c.output.begin(), c.output.end(), 0.0f);
+            std::fill (c.spectraRe.begin(), c.spectraRe.end(), 0.0f);
+            std::fill (c.spectraIm.begin(), c.spectraIm.end(), 0.0f);
+        }
+
+        fill = 0;
+        head = 0;
+    }
+
+    /** Half the kernel, plus one partition of input buffering. */
+    int getLatencySamples() const noexcept { return kernelLength / 2 + partitionSize; }
+
+    /** Asks for a kernel matching curve. Lock-free and cheap, so it can be
+        called from the audio thread on every change.
+    */
+    void requestCurve (const Curve& curve, double designSampleRate) noexcept
+    {
+        if (curve == lastRequest && designSampleRate == lastRequestRate)
+            return;
+
+        lastRequest     = curve;
+        lastRequestRate = designSampleRate;
+
+        for (size_t band = 0; band < curve.size(); ++band)
+        {
+            requestedCurve[band * 3 + 0].store (curve[band].freq, std::memory_order_relaxed);
+            requestedCurve[band * 3 + 1].store (curve[band].gainDb, std::memory_order_relaxed);
+            requestedCurve[band * 3 + 2].store (curve[band].q, std::memory_order_relaxed);
+        }
+
+        requestedRate.store (designSampleRate, std::memory_order_relaxed);
+        requestVersion.fetch_add (1, std::memory_order_release);
+    }
+
+    /** True until the kernel for the latest requestCurve() is in use. */
+    bool isKernelPending() const noexcept
+    {
+        return activeVersion.load() != requestVersion.load();
+    }
+
+    /** Convolves numChannels channels in place. */
+    void process (float* const* channels, int numChannels, int numSamples) noexcept
+    {
+        jassert (numChannels <= (int) channelStates.size());
+
+        for (int position = 0; position < numSamples;)
+        {
+            const int numToDo = juce::jmin (numSamples - position, partitionSize - fill);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto& c    = channelStates[(size_t) ch];
+                auto* data = channels[ch] + position;
+
+                std::copy (data, data + numToDo, c.input.begin() + partitionSize + fill);
+                std::copy (c.output.begin() + fill, c.output.begin() + fill + numToDo, data);
+            }
+
+            fill += numToDo;
+            position += numToDo;
+
+            if (fill == partitionSize)
+            {
+                processPartition (numChannels);
+                fill = 0;
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    static constexpr double kernelSeconds = 0.17;
+    static constexpr int fftOrder = 9;
+    static constexpr int fftSize  = partitionSize * 2;
+    static constexpr int numBins  = partitionSize + 1;
+    static constexpr int pollIntervalMs = 10;
+
+    static_assert (1 << fftOrder == fftSize);
+
+    // One partitioned kernel spectrum: numPartitions rows of numBins bins
+    struct Kernel
+    {
+        std::vector<float> re, im;
+    };
+
+    struct Channel
+    {
+        std::vector<float> input;                // previous and current partition
+        std::vector<float> output;               // the last partition's result
+        std::vector<float> spectraRe, spectraIm; // frequency-domain delay line
+    };
+
+    class Builder : public juce::Thread
+    {
+    public:
+        explicit Builder (LinearPhaseEq& e) : juce::Thread ("Linear-phase EQ builder"), engine (e) {}
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                engine.buildPendingKernel();
+                wait (pollIntervalMs);
+            }
+        }
+
+    private:
+        LinearPhaseEq& engine;
+    };
+
+    //==============================================================================
+    void processPartition (int numChannels) noexcept
+    {
+        // Pick up a new kernel if the builder has published one. Taking it is
+        // a CAS on the same word the builder publishes with, so by the time
+        // the builder next looks for a free slot it sees this one in use.
+        auto word  = slotState.load();
+        auto slots = Slots::unpack (word);
+        const int front = slots.front;
+
+        while (slots.published != front
+               && ! slotState.compare_exchange_weak (word, Slots { slots.published, slots.published, front }.pack()))
+            slots = Slots::unpack (word);
+
+        const int published = slots.published;
+        const bool fading   = published != front;
+
+        if (fading)
+            activeVersion.store (kernelVersions[(size_t) published]);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& c = channelStates[(size_t) ch];
+
+            std::copy (c.input.begin(), c.input.end(), fftBuffer.begin());
+            std::fill (fftBuffer.begin() + fftSize, fftBuffer.end(), 0.0f);
+            fftFrame.performRealOnlyForwardTransform (fftBuffer.data(), true);
+
+            const auto row = (size_t) (head * numBins);
+            for (size_t bin = 0; bin < (size_t) numBins; ++bin)
+            {
+                c.spectraRe[row + bin] = fftBuffer[bin * 2];
+                c.spectraIm[row + bin] = fftBuffer[bin * 2 + 1];
+            }
+
+            std::copy (c.input.begin() + partitionSize, c.input.end(), c.input.begin());
+
+            convolve (c, kernels[(size_t) published], c.output.data());
+
+            if (fading)
+            {
+                convolve (c, kernels[(size_t) front], fadeBuffer.data());
+
+                const float step = 1.0f / (float) partitionSize;
+                for (size_t i = 0; i < (size_t) partitionSize; ++i)
+                    c.output[i] = fadeBuffer[i] + ((float) i * step) * (c.output[i] - fadeBuffer[i]);
+            }
+        }
+
+        head = (head + 1) % numPartitions;
+
+        // The old kernel is free again: set previous to none, whatever the
+        // builder has published meanwhile
+        if (fading)
+            slotState.fetch_or (Slots::none << Slots::previousShift);
+    }
+
+    void convolve (const Channel& c, const Kernel& kernel, float* out) noexcept
+    {
+        std::fill (accumulatorRe.begin(), accumulatorRe.end(), 0.0f);
+        std::fill (accumulatorIm.begin(), accumulatorIm.end(), 0.0f);
+
+        auto* accRe = accumulatorRe.data();
+        auto* accIm = accumulatorIm.data();
+
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            const auto row = (size_t) (((head - p + numPartitions) % numPartitions) * numBins);
+            const auto* xr = c.spectraRe.data() + row;
+            const auto* xi = c.spectraIm.data() + row;
+            const auto* hr = kernel.re.data() + (size_t) (p * numBins);
+            const auto* hi = kernel.im.data() + (size_t) (p * numBins);
+
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                accRe[bin] += xr[bin] * hr[bin] - xi[bin] * hi[bin];
+                accIm[bin] += xr[bin] * hi[bin] + xi[bin] * hr[bin];
+            }
+        }
+
+        for (size_t bin = 0; bin < (size_t) numBins; ++bin)
+        {
+            fftBuffer[bin * 2]     = accRe[bin];
+            fftBuffer[bin * 2 + 1] = accIm[bin];
+        }
+
+        fftFrame.performRealOnlyInverseTransform (fftBuffer.data());
+
+        // Overlap-save: only the second half is free of wrap-around
+        std::copy (fftBuffer.begin() + partitionSize, fftBuffer.begin() + fftSize, out);
+    }
+
+    //==============================================================================
+    // Background thread from here on
+
+    void buildPendingKernel()
+    {
+        const auto version = requestVersion.load (std::memory_order_acquire);
+        if (version == builtVersion)
+            return;
+
+        // Only ever write a slot the audio thread can't be reading. If it is
+        // mid-crossfade all three may be taken; try again next poll. A free
+        // slot stays free until we publish it, as the audio thread only ever
+        // takes the published one.
+        const auto slots = Slots::unpack (slotState.load());
+
+        int slot = 0;
+        while (slots.uses (slot))
+            if (++slot == (int) kernels.size())
+                return;
+
+        // A request landing while we read is caught on the next poll, as the
+        // version will have moved on again.
+        Curve curve;
+        for (size_t band = 0; band < curve.size(); ++band)
+        {
+            curve[band].freq   = requestedCurve[band * 3 + 0].load (std::memory_order_relaxed);
+            curve[band].gainDb = requestedCurve[band * 3 + 1].load (std::memory_order_relaxed);
+            curve[band].q      = requestedCurve[band * 3 + 2].load (std::memory_order_relaxed);
+        }
+
+        designKernel (curve, requestedRate.load (std::memory_order_relaxed), kernels[(size_t) slot]);
+        kernelVersions[(size_t) slot] = version;
+        builtVersion = version;
+
+        // Publish, keeping whatever the audio thread has since done to front
+        // and previous
+        auto word = slotState.load();
+        while (! slotState.compare_exchange_weak (word, (word & ~Slots::mask) | slot))
+        {
+        }
+    }
+
+    void designKernel (const Curve& curve, double designSampleRate, Kernel& kernel)
+    {
+        std::array<BiquadCoefficients<double>, (size_t) NumBands> coeffs;
+        for (size_t band = 0; band < coeffs.size(); ++band)
+        {
+            const auto& b = curve[band];
+            const auto freq = juce::jmin ((double) b.freq, 0.49 * designSampleRate);
+            coeffs[band] = FilterDesign::makeBand (bandTypes[band], designSampleRate, freq, (double) b.gainDb, (double) b.q);
+        }
+
+        // Zero-phase spectrum: the cascade's magnitude on every bin
+        std::fill (designBuffer.begin(), designBuffer.end(), 0.0f);
+        for (int bin = 0; bin <= kernelLength / 2; ++bin)
+        {
+            const double omega = juce::MathConstants<double>::twoPi * bin * sampleRate / (kernelLength * designSampleRate);
+            const auto z1 = std::polar (1.0, -omega);
+            const auto z2 = z1 * z1;
+
+            double magnitude = 1.0;
+            for (const auto& c : coeffs)
+                magnitude *= std::abs ((c.b0 + c.b1 * z1 + c.b2 * z2) / (1.0 + c.a1 * z1 + c.a2 * z2));
+
+            designBuffer[(size_t) bin * 2] = (float) magnitude;
+        }
+
+        designFFT->performRealOnlyInverseTransform (designBuffer.data());
+
+        // The impulse is centred on sample 0; rotate it to the middle and window it
+        const auto half = (size_t) kernelLength / 2;
+        for (size_t n = 0; n < impulse.size(); ++n)
+            impulse[n] = designBuffer[(n + half) % impulse.size()] * window[n];
+
+        auto& buffer = designFrame;
+        for (int p = 0; p < numPartitions; ++p)
+        {
+            std::fill (buffer.begin(), buffer.end(), 0.0f);
+            std::copy_n (impulse.begin() + p * partitionSize, partitionSize, buffer.begin());
+            builderFFT.performRealOnlyForwardTransform (buffer.data(), true);
+
+            const auto row = (size_t) (p * numBins);
+            for (size_t bin = 0; bin < (size_t) numBins; ++bin)
+            {
+                kernel.re[row + bin] = buffer[bin * 2];
+                kernel.im[row + bin] = buffer[bin * 2 + 1];
+            }
+        }
+    }
+
+    //==============================================================================
+    std::array<BandType, (size_t) NumBands> bandTypes;
+    double sampleRate { 44100.0 };
+    int kernelLength { 0 }, numPartitions { 1 };
+
+    // Audio thread
+    juce::dsp::FFT fftFrame { fftOrder };
+    std::vector<Channel> channelStates;
+    std::vector<float> fftBuffer, accumulatorRe, accumulatorIm, fadeBuffer;
+    int fill { 0 }, head { 0 };
+    Curve lastRequest {};
+    double lastRequestRate { 0.0 };
+
+    // Builder thread
+    juce::dsp::FFT builderFFT { fftOrder };
+    std::unique_ptr<juce::dsp::FFT> designFFT;
+    std::vector<float> designBuffer, impulse, window;
+    std::array<float, (size_t) fftSize * 2> designFrame {};
+    juce::uint32 builtVersion { 0 };
+
+    // Which kernels are in use: the builder's latest (published), the one
+    // the audio thread convolves with (front) and, during a crossfade, the
+    // one it fades from (previous). They share one atomic word so either
+    // thread sees and changes all three together. Only the builder writes a
+    // kernel slot or published; only the audio thread writes front and
+    // previous.
+    struct Slots
+    {
+        static constexpr int none = 3, mask = 3, frontShift = 2, previousShift = 4;
+
+        int published, front, previous;
+
+        static Slots unpack (int word) noexcept
+        {
+            return { word & mask, (word >> frontShift) & mask, (word >> previousShift) & mask };
+        }
+
+        int pack() const noexcept { return published | front << frontShift | previous << previousShift; }
+        bool uses (int slot) const noexcept { return slot == published || slot == front || slot == previous; }
+    };
+
+    std::array<Kernel, 3> kernels;
+    std::array<juce::uint32, 3> kernelVersions {};
+    std::atomic<int> slotState { Slots { 0, 0, Slots::none }.pack() };
+
+    std::array<std::atomic<float>, (size_t) NumBands * 3> requestedCurve {};
+    std::atomic<double> requestedRate { 44100.0 };
+    std::atomic<juce::uint32> requestVersion { 0 }, activeVersion { 0 };
+
+    Builder builder { *this };
+
+    JUCE_DECLARE_NON_COPYABLE (LinearPhaseEq)
+};
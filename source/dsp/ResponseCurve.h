@@ -0,0 +1,104 @@
+#pragma once
+
+#include "BiquadCascade.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+
+//==============================================================================
+/**
+    The magnitude response of a series of biquad bands, in dB, on a fixed
+    log-spaced frequency grid. It is for drawing, on the message thread.
+
+    Each band keeps its own row of dB values, so moving one knob recomputes
+    one row and sums the rows again. Nothing else is recomputed. A row is one
+    pass over the grid in the sin^2 (w / 2) form of |H|^2:
+
+        |B|^2 = (b0 + b1 + b2)^2 - 4 (b0 b1 + 4 b0 b2 + b1 b2) phi + 16 b0 b2 phi^2
+
+    with phi precomputed per grid point, and the same for A. The loop has
+    no branches or trig, so it vectorises. This form also keeps its
+    precision for low shelves at high sample rates, where the cos (w) form
+    cancels away in double.
+*/
+template <int NumBands>
+class ResponseCurve
+{
+public:
+    static constexpr int numPoints = 256;
+    static constexpr double minHz = 20.0, maxHz = 20000.0;
+
+    ResponseCurve()
+    {
+        for (auto& row : rows)
+            row.fill (0.0f);
+        total.fill (0.0f);
+    }
+
+    static double frequencyAt (int point) noexcept
+    {
+        return minHz * std::pow (maxHz / minHz, point / (double) (numPoints - 1));
+    }
+
+    /** Rebuilds the grid for a new rate. Every band needs setting again after this. */
+    void setSampleRate (double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+
+        // Points past Nyquist read as Nyquist
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto halfOmega = juce::MathConstants<double>::pi * juce::jmin (frequencyAt (i), 0.5 * sampleRate) / sampleRate;
+            phi[(size_t) i] = juce::square (std::sin (halfOmega));
+        }
+    }
+
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    /** Recomputes one band's row. */
+    void setBand (int band, const BiquadCoefficients<double>& c) noexcept
+    {
+        const auto nSum  = juce::square (c.b0 + c.b1 + c.b2);
+        const auto nLin  = -4.0 * (c.b0 * c.b1 + 4.0 * c.b0 * c.b2 + c.b1 * c.b2);
+        const auto nQuad = 16.0 * c.b0 * c.b2;
+        const auto dSum  = juce::square (1.0 + c.a1 + c.a2);
+        const auto dLin  = -4.0 * (c.a1 + 4.0 * c.a2 + c.a1 * c.a2);
+        const auto dQuad = 16.0 * c.a2;
+
+        std::array<double, numPoints> power;
+        for (size_t i = 0; i < power.size(); ++i)
+        {
+            const auto p = phi[i];
+            power[i] = (nSum + p * (nLin + p * nQuad)) / (dSum + p * (dLin + p * dQuad));
+        }
+
+        auto& row = rows[(size_t) band];
+        for (size_t i = 0; i < row.size(); ++i)
+            row[i] = (float) (10.0 * std::log10 (juce::jmax (power[i], 1.0e-12)));
+
+        totalDirty = true;
+    }
+
+    float getBandDb (int band, int point) const noexcept { return rows[(size_t) band][(size_t) point]; }
+
+    /** The whole series, numPoints values. */
+    const float* getTotalDb() noexcept
+    {
+        if (totalDirty)
+        {
+            juce::FloatVectorOperations::copy (total.data(), rows[0].data(), numPoints);
+            for (size_t band = 1; band < rows.size(); ++band)
+                juce::FloatVectorOperations::add (total.data(), rows[band].data(), numPoints);
+
+            totalDirty = false;
+        }
+
+        return total.data();
+    }
+
+private:
+    double sampleRate {};
+    std::array<double, numPoints> phi {};
+    std::array<std::array<float, numPoints>, (size_t) NumBands> rows;
+    std::array<float, numPoints> total;
+    bool totalDirty = false;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../AnalyserFifo.h"
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+//==============================================================================
+/**
+    The analyser's number crunching: keeps the latest fftSize samples read
+    from an AnalyserFifo and turns them into a smoothed magnitude spectrum.
+
+    Everything here runs on the thread that draws, never the audio thread.
+    Each update() is one Hann window, one real FFT and a pass over the bins:
+    levels jump straight up to a new peak and fall back by releaseFactor of
+    the difference per update, so at 60 updates a second peaks hang long
+    enough to read.
+
+    Levels are in dB, scaled so a full-scale sine centred on a bin reads 0.
+*/
+class SpectrumAnalysis
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize  = 1 << fftOrder;
+    static constexpr int numBins  = fftSize / 2 + 1;
+
+    static constexpr float floorDb       = -120.0f;
+    static constexpr float releaseFactor = 0.15f;
+
+    SpectrumAnalysis()
+        : window ((size_t) fftSize),
+          history ((size_t) fftSize, 0.0f),
+          fftData ((size_t) fftSize * 2, 0.0f),
+          levels ((size_t) numBins, floorDb)
+    {
+        juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) fftSize,
+                                                                  juce::dsp::WindowingFunction<float>::hann, false);
+    }
+
+    /** Takes whatever the audio thread has pushed since the last call. */
+    void pull (AnalyserFifo& fifo) noexcept
+    {
+        // Oldest first, wrapping round history; anything older than the
+        // last fftSize samples is overwritten before it is ever looked at
+        while (fifo.getNumReady() > 0)
+            writePosition = (writePosition + fifo.pop (history.data() + writePosition, fftSize - writePosition)) % fftSize;
+    }
+
+    /** Recomputes the spectrum from the latest fftSize samples. */
+    void update() noexcept
+    {
+        const int tail = fftSize - writePosition;
+        std::copy_n (history.data() + writePosition, tail, fftData.data());
+        std::copy_n (history.data(), writePosition, fftData.data() + tail);
+
+        juce::FloatVectorOperations::multiply (fftData.data(), window.data(), fftSize);
+        fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+        // The Hann window sums to fftSize / 2, so a sine of amplitude a peaks at a * fftSize / 4
+        constexpr float scale = 4.0f / (float) fftSize;
+
+        for (size_t bin = 0; bin < levels.size(); ++bin)
+        {
+            const auto db = juce::Decibels::gainToDecibels (fftData[bin] * scale, floorDb);
+            auto& level = levels[bin];
+            level = db >= level ? db : level + (db - level) * releaseFactor;
+        }
+    }
+
+    void reset() noexcept
+    {
+        std::fill (history.begin(), history.end(), 0.0f);
+        std::fill (levels.begin(), levels.end(), floorDb);
+        writePosition = 0;
+    }
+
+    float getLevel (int bin) const noexcept { return levels[(size_t) bin]; }
+
+    /** The loudest bin between two frequencies, for drawing one pixel column. */
+    float getPeakLevel (double lowHz, double highHz, double sampleRate) const noexcept
+    {
+        const auto binWidth = sampleRate / fftSize;
+        const int first = juce::jlimit (0, numBins - 1, (int) std::floor (lowHz / binWidth + 0.5));
+        const int last  = juce::jlimit (first, numBins - 1, (int) std::floor (highHz / binWidth + 0.5));
+
+        auto peak = levels[(size_t) first];
+        for (int bin = first + 1; bin <= last; ++bin)
+            peak = juce::jmax (peak, levels[(size_t) bin]);
+        return peak;
+    }
+
+private:
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<float> window, history, fftData, levels;
+    int writePosition = 0;
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <array>
+
+//==============================================================================
+/** Coefficients for one topology-preserving (trapezoidal) state-variable
+    filter in Andrew Simper's formulation:
+
+        v3 = x - ic2;  v1 = a1 ic1 + a2 v3;  v2 = ic2 + a2 ic1 + a3 v3
+        y  = m0 x + m1 v1 + m2 v2
+
+    a1..a3 depend only on g = tan (pi f / fs) and the damping k, and the state
+    holds integrator values rather than past outputs, so low cutoffs keep
+    their precision in float and coefficients can change between any two
+    samples without the glitches a direct-form biquad produces.
+*/
+template <typename SampleType>
+struct SvfCoefficients
+{
+    SampleType a1 { 1 }, a2 {}, a3 {}, m0 { 1 }, m1 {}, m2 {};
+
+    /** Builds a set from the pre-warped cutoff g, damping k and output mix. */
+    static SvfCoefficients fromGK (SampleType g, SampleType k, SampleType mix0, SampleType mix1, SampleType mix2) noexcept
+    {
+        const auto d = SampleType (1) / (SampleType (1) + g * (g + k));
+        return { d, g * d, g * g * d, mix0, mix1, mix2 };
+    }
+
+    bool operator== (const SvfCoefficients&) const = default;
+};
+
+//==============================================================================
+/**
+    The SVF counterpart of BiquadCascade: NumStages filters in series over up
+    to NumLanes channels, one per lane, with the output gain fused into the
+    same pass. Drop-in compatible with BiquadCascade apart from the
+    coefficient type.
+*/
+template <typename SampleType, int NumStages, int NumLanes = 4>
+class SvfCascade
+{
+public:
+    static constexpr int numStages = NumStages;
+    static constexpr int numLanes  = NumLanes;
+
+    using Coefficients = SvfCoefficients<SampleType>;
+
+    SvfCascade() noexcept
+    {
+        for (int stage = 0; stage < NumStages; ++stage)
+            setCoefficients (stage, Coefficients {});
+    }
+
+    /** Clears the filter state, leaving the coefficients untouched. */
+    void reset() noexcept
+    {
+        for (auto& s : stages)
+        {
+            std::fill (std::begin (s.ic1), std::end (s.ic1), SampleType());
+            std::fill (std::begin (s.ic2), std::end (s.ic2), SampleType());
+        }
+    }
+
+    /** Sets one stage's coefficients on every lane. */
+    void setCoefficients (int stage, const Coefficients& c) noexcept
+    {
+        for (int lane = 0; lane < NumLanes; ++lane)
+            setCoefficients (stage, lane, c);
+    }
+
+    /** Sets one stage's coefficients on a single lane. */
+    void setCoefficients (int stage, int lane, const Coefficients& c) noexcept
+    {
+        jassert (juce::isPositiveAndBelow (stage, NumStages) && juce::isPositiveAndBelow (lane, NumLanes));
+
+        auto& s = stages[(size_t) stage];
+        s.a1[lane] = c.a1;
+        s.a2[lane] = c.a2;
+        s.a3[lane] = c.a3;
+        s.m0[lane] = c.m0;
+        s.m1[lane] = c.m1;
+        s.m2[lane] = c.m2;
+    }
+
+    Coefficients getCoefficients (int stage, int lane) const noexcept
+    {
+        const auto& s = stages[(size_t) stage];
+        return { s.a1[lane], s.a2[lane], s.a3[lane], s.m0[lane], s.m1[lane], s.m2[lane] };
+    }
+
+    /** Filters numChannels (<= NumLanes) channels in place, multiplying each
+        sample by nextGain() in the same loop.
+    */
+    template <typename GainSource>
+    void process (SampleType* const* channels, int numChannels, int numSamples, GainSource&& nextGain) noexcept
+    {
+        jassert (numChannels <= NumLanes);
+        run<false> (channels, numChannels, numSamples, nextGain);
+    }
+
+    /** Filters a stereo pair as mid (lane 0) and side (lane 1), encoding
+        and decoding inside the filter loop (see BiquadCascade::processMidSide).
+    */
+    template <typename GainSource>
+    void processMidSide (SampleType* const* channels, int numSamples, GainSource&& nextGain) noexcept
+    {
+        static_assert (NumLanes >= 2, "mid and side need a lane each");
+        run<true> (channels, 2, numSamples, nextGain);
+    }
+
+private:
+    template <bool MidSide, typename GainSource>
+    void run (SampleType* const* channels, int numChannels, int numSamples, GainSource&& nextGain) noexcept
+    {
+        // Local copy keeps the state in registers (see BiquadCascade::process)
+        auto local = stages;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            alignas (16) SampleType x[NumLanes] {};
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                x[ch] = channels[ch][i];
+
+            if constexpr (MidSide)
+            {
+                const auto left = x[0], right = x[1];
+                x[0] = SampleType (0.5) * (left + right);
+                x[1] = SampleType (0.5) * (left - right);
+            }
+
+            for (auto& s : local)
+            {
+                for (int lane = 0; lane < NumLanes; ++lane)
+                {
+                    const auto v0 = x[lane];
+                    const auto v3 = v0 - s.ic2[lane];
+                    const auto v1 = s.a1[lane] * s.ic1[lane] + s.a2[lane] * v3;
+                    const auto v2 = s.ic2[lane] + s.a2[lane] * s.ic1[lane] + s.a3[lane] * v3;
+                    s.ic1[lane] = SampleType (2) * v1 - s.ic1[lane];
+                    s.ic2[lane] = SampleType (2) * v2 - s.ic2[lane];
+                    x[lane] = s.m0[lane] * v0 + s.m1[lane] * v1 + s.m2[lane] * v2;
+                }
+            }
+
+            const SampleType gain = nextGain();
+
+            if constexpr (MidSide)
+            {
+                channels[0][i] = (x[0] + x[1]) * gain;
+                channels[1][i] = (x[0] - x[1]) * gain;
+            }
+            else
+            {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    channels[ch][i] = x[ch] * gain;
+            }
+        }
+
+        stages = local;
+    }
+
+    struct Stage
+    {
+        alignas (16) SampleType a1[NumLanes] {};
+        alignas (16) SampleType a2[NumLanes] {};
+        alignas (16) SampleType a3[NumLanes] {};
+        alignas (16) SampleType m0[NumLanes] {};
+        alignas (16) SampleType m1[NumLanes] {};
+        alignas (16) SampleType m2[NumLanes] {};
+        alignas (16) SampleType ic1[NumLanes] {};
+        alignas (16) SampleType ic2[NumLanes] {};
+    };
+
+    std::array<Stage, NumStages> stages;
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "FastMath.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <array>
+
+//==============================================================================
+/**
+    A transient shaper: boosts or cuts the attack and the sustain of whatever
+    comes through, independently.
+
+    Two peak envelope followers run side by side on one stereo-linked
+    detector (the loudest channel at each sample), so every channel gets the
+    same gain and the image doesn't move. The fast one tracks onsets within
+    a millisecond and lets go quickly; the slow one lags on both. Where the
+    fast envelope sits above the slow one the signal is in an attack, where
+    it sits below, in a decay. Their ratio in dB, scaled by sensitivityDb and
+    clamped to [0, 1] either side, weights the attack and sustain amounts.
+
+    The block goes through in chunks of chunkSize samples, in four passes
+    over small scratch arrays that stay in L1: detector, envelopes, gain and
+    apply. Only the envelope pass is a true recurrence; it picks its
+    coefficients with selects rather than branches. The others are plain
+    array loops with no branches at all, so they vectorise, including the
+    FastMath log2/exp2 in the gain pass. Nothing allocates.
+*/
+template <typename SampleType>
+class TransientShaper
+{
+public:
+    static constexpr int chunkSize = 256;
+
+    /** Sets the envelope time constants for the rate and clears the state. */
+    void prepare (double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+
+        fastAttack  = coefficientFor (fastAttackSeconds);
+        fastRelease = coefficientFor (fastReleaseSeconds);
+        slowAttack  = coefficientFor (slowAttackSeconds);
+        slowRelease = coefficientFor (slowReleaseSeconds);
+
+        attackAmount.reset (sampleRate, amountSmoothingSeconds);
+        sustainAmount.reset (sampleRate, amountSmoothingSeconds);
+
+        reset();
+    }
+
+    /** Clears the envelopes and lands any amount ramp. */
+    void reset() noexcept
+    {
+        fastEnvelope = slowEnvelope = SampleType();
+        attackAmount.setCurrentAndTargetValue (attackAmount.getTargetValue());
+        sustainAmount.setCurrentAndTargetValue (sustainAmount.getTargetValue());
+    }
+
+    /** Sets the boost (or cut, if negative) in dB given to attacks and
+        sustains. Changes ramp over amountSmoothingSeconds.
+    */
+    void setAmounts (SampleType attackDb, SampleType sustainDb) noexcept
+    {
+        attackAmount.setTargetValue (attackDb);
+        sustainAmount.setTargetValue (sustainDb);
+    }
+
+    /** False when both amounts are, and stay, at 0 dB. process() then only
+        keeps the envelopes tracking and leaves the audio alone.
+    */
+    bool isActive() const noexcept
+    {
+        return attackAmount.isSmoothing() || sustainAmount.isSmoothing()
+            || attackAmount.getTargetValue() != SampleType() || sustainAmount.getTargetValue() != SampleType();
+    }
+
+    /** Shapes numChannels channels in place, with one shared gain. */
+    void process (SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (numChannels <= 0)
+            return;
+
+        for (int position = 0; position < numSamples; position += chunkSize)
+            processChunk (channels, numChannels, position, juce::jmin (chunkSize, numSamples - position));
+    }
+
+private:
+    static constexpr double fastAttackSeconds  = 0.0005;
+    static constexpr double fastReleaseSeconds = 0.05;
+    static constexpr double slowAttackSeconds  = 0.02;
+    static constexpr double slowReleaseSeconds = 0.25;
+    static constexpr double amountSmoothingSeconds = 0.02;
+
+    // Envelope ratio that gives the full amount
+    static constexpr SampleType sensitivityDb = SampleType (6);
+
+    // Keeps log2 off denormals and zero in silence
+    static constexpr SampleType envelopeFloor = SampleType (1.0e-6);
+
+    SampleType coefficientFor (double seconds) const noexcept
+    {
+        return static_cast<SampleType> (std::exp (-1.0 / (seconds * sampleRate)));
+    }
+
+    void processChunk (SampleType* const* channels, int numChannels, int start, int numSamples) noexcept
+    {
+        const auto n = (size_t) numSamples;
+
+        // Stereo-linked detector: the loudest channel at each sample
+        for (size_t i = 0; i < n; ++i)
+            fast[i] = std::abs (channels[0][(size_t) start + i]);
+
+        for (int ch = 1; ch < numChannels; ++ch)
+        {
+            const auto* x = channels[ch] + start;
+            for (size_t i = 0; i < n; ++i)
+                fast[i] = std::max (fast[i], std::abs (x[i]));
+        }
+
+        // Both followers in one loop, so their recurrences overlap
+        SampleType f = fastEnvelope, s = slowEnvelope;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const SampleType x = fast[i];
+            f = x + (x > f ? fastAttack : fastRelease) * (f - x);
+            s = x + (x > s ? slowAttack : slowRelease) * (s - x);
+            fast[i] = f;
+            slow[i] = s;
+        }
+        fastEnvelope = f;
+        slowEnvelope = s;
+
+        if (! isActive())
+            return;
+
+        fillAmounts (attackAmount, attackDb.data(), n);
+        fillAmounts (sustainAmount, sustainDb.data(), n);
+
+        // gain = 10^(dB / 20) = 2^(dB * log2 (10) / 20)
+        constexpr SampleType log2ToWeight       = SampleType (6.020599913279624) / sensitivityDb;
+        constexpr SampleType decibelsToExponent = SampleType (3.321928094887362 / 20.0);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const SampleType ratio = (FastMath::log2 (std::max (fast[i], envelopeFloor))
+                                      - FastMath::log2 (std::max (slow[i], envelopeFloor))) * log2ToWeight;
+
+            const SampleType attackWeight  = std::clamp (ratio, SampleType(), SampleType (1));
+            const SampleType sustainWeight = std::clamp (-ratio, SampleType(), SampleType (1));
+
+            gain[i] = FastMath::exp2 ((attackDb[i] * attackWeight + sustainDb[i] * sustainWeight) * decibelsToExponent);
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::multiply (channels[ch] + start, gain.data(), numSamples);
+    }
+
+    static void fillAmounts (juce::SmoothedValue<SampleType>& amount, SampleType* dest, size_t n) noexcept
+    {
+        if (! amount.isSmoothing())
+        {
+            std::fill (dest, dest + n, amount.getTargetValue());
+            return;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            dest[i] = amount.getNextValue();
+    }
+
+    double sampleRate { 44100.0 };
+    SampleType fastAttack {}, fastRelease {}, slowAttack {}, slowRelease {};
+    SampleType fastEnvelope {}, slowEnvelope {};
+
+    juce::SmoothedValue<SampleType> attackAmount, sustainAmount;
+
+    // Per-chunk scratch. fast holds the detector until the envelope pass
+    // overwrites it.
+    alignas (16) std::array<SampleType, chunkSize> fast {};
+    alignas (16) std::array<SampleType, chunkSize> slow {};
+    alignas (16) std::array<SampleType, chunkSize> attackDb {};
+    alignas (16) std::array<SampleType, chunkSize> sustainDb {};
+    alignas (16) std::array<SampleType, chunkSize> gain {};
+};
@@ -0,0 +1,92 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    // Stands in for a cascade and remembers what the kernel wrote
+    struct RecordingCascade
+    {
+        std::array<BiquadCoefficients<float>, 3> coefficients {};
+        int numWrites = 0;
+
+        void setCoefficients (int stage, const BiquadCoefficients<float>& c)
+        {
+            coefficients[(size_t) stage] = c;
+            ++numWrites;
+        }
+    };
+
+    constexpr std::array<BandType, 3> bandTypes { BandType::LowShelf, BandType::PeakBell, BandType::HighShelf };
+}
+
+TEST_CASE ("FastMath stays within its stated error bounds", "[dsp]")
+{
+    for (double x = 0.0; x < 0.499; x += 1.0e-4)
+        REQUIRE (FastMath::tanPi (x) == Catch::Approx (std::tan (juce::MathConstants<double>::pi * x)).epsilon (2.0e-8));
+
+    for (double x = -20.0; x < 20.0; x += 1.0e-3)
+        REQUIRE (FastMath::exp2 (x) == Catch::Approx (std::exp2 (x)).epsilon (2.0e-9));
+
+    for (double x = 1.0e-6; x < 100.0; x *= 1.001)
+        REQUIRE (FastMath::log2 (x) == Catch::Approx (std::log2 (x)).margin (2.0e-5));
+}
+
+TEST_CASE ("CoefficientKernel matches the cookbook formulas", "[dsp]")
+{
+    for (const double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+    {
+        for (float freq = 20.0f; freq <= 20000.0f; freq *= 1.3f)
+        {
+            for (const float gain : { -12.0f, -3.0f, 0.0f, 6.0f, 12.0f })
+            {
+                for (const float q : { 0.1f, 0.707f, 10.0f })
+                {
+                    CoefficientKernel<float, 3> kernel;
+                    RecordingCascade cascade;
+                    for (int band = 0; band < 3; ++band)
+                        kernel.setBand (band, freq, gain, q);
+
+                    kernel.update<BiquadTopology> (bandTypes, sampleRate, cascade);
+
+                    for (size_t band = 0; band < 3; ++band)
+                    {
+                        // Compare against the double-precision design; the
+                        // float cookbook formulas themselves are about 2e-6 off.
+                        const auto exact = FilterDesign::makeBand (bandTypes[band], sampleRate, (double) freq, (double) gain, (double) q);
+                        const auto& fast = cascade.coefficients[band];
+
+                        constexpr double margin = 5.0e-6;
+                        CHECK (fast.b0 == Catch::Approx (exact.b0).margin (margin));
+                        CHECK (fast.b1 == Catch::Approx (exact.b1).margin (margin));
+                        CHECK (fast.b2 == Catch::Approx (exact.b2).margin (margin));
+                        CHECK (fast.a1 == Catch::Approx (exact.a1).margin (margin));
+                        CHECK (fast.a2 == Catch::Approx (exact.a2).margin (margin));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE ("CoefficientKernel only redesigns dirty bands", "[dsp]")
+{
+    CoefficientKernel<float, 3> kernel;
+    RecordingCascade cascade;
+
+    kernel.update<BiquadTopology> (bandTypes, 48000.0, cascade);
+    CHECK (cascade.numWrites == 0);
+
+    kernel.setBand (1, 1000.0f, 6.0f, 1.0f);
+    kernel.update<BiquadTopology> (bandTypes, 48000.0, cascade);
+    CHECK (cascade.numWrites == 1);
+    CHECK (cascade.coefficients[0] == BiquadCoefficients<float> {});
+    CHECK (cascade.coefficients[2] == BiquadCoefficients<float> {});
+    CHECK_FALSE (kernel.isDirty());
+
+    // A prewarped update keeps its own K, s and 1/Q rather than the settings
+    kernel.setBandPrewarped (1, 0.1f, 1.0f, 1.0f);
+    kernel.update<BiquadTopology> (bandTypes, 48000.0, cascade);
+    CHECK (cascade.numWrites == 2);
+    CHECK (cascade.coefficients[1] == FilterDesign::makeBandPrewarped (BandType::PeakBell, 0.1f, 1.0f, 1.0f));
+}
@@ -0,0 +1,79 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+TEST_CASE ("Prewarped designs track the cookbook formulas", "[dsp]")
+{
+    for (const double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+    {
+        PrewarpTable<float> table;
+        table.prepare (sampleRate);
+
+        for (const auto type : { BandType::LowShelf, BandType::PeakBell, BandType::HighShelf })
+        {
+            for (float freq = 20.0f; freq <= 20000.0f; freq *= 1.3f)
+            {
+                for (const float gain : { -12.0f, -3.0f, 6.0f, 12.0f })
+                {
+                    for (const float q : { 0.1f, 0.707f, 10.0f })
+                    {
+                        const auto exact = FilterDesign::makeBand (type, sampleRate, freq, gain, q);
+                        const auto v     = BandSmoother<float>::toValues (table, freq, gain, q);
+                        const auto fast  = FilterDesign::makeBandPrewarped (type, table.lookup (v.position), v.s, v.invQ);
+
+                        // Table interpolation error peaks in the cramped region near Nyquist
+                        constexpr double margin = 5.0e-3;
+                        CHECK (fast.b0 == Catch::Approx (exact.b0).margin (margin));
+                        CHECK (fast.b1 == Catch::Approx (exact.b1).margin (margin));
+                        CHECK (fast.b2 == Catch::Approx (exact.b2).margin (margin));
+                        CHECK (fast.a1 == Catch::Approx (exact.a1).margin (margin));
+                        CHECK (fast.a2 == Catch::Approx (exact.a2).margin (margin));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE ("BandSmoother lands exactly on its target", "[dsp]")
+{
+    BandSmoother<float> smoother;
+    smoother.setRampLength (10);
+    smoother.setCurrentAndTarget ({ 100.0f, 1.0f, 1.0f });
+    smoother.setTarget ({ 200.0f, 2.0f, 0.5f });
+
+    for (int i = 0; i < 9; ++i)
+    {
+        REQUIRE (smoother.isSmoothing());
+        smoother.advance();
+    }
+
+    CHECK (smoother.getCurrent().position == Catch::Approx (190.0f));
+
+    smoother.advance();
+    CHECK_FALSE (smoother.isSmoothing());
+    CHECK (smoother.getCurrent().position == 200.0f);
+    CHECK (smoother.getCurrent().s == 2.0f);
+    CHECK (smoother.getCurrent().invQ == 0.5f);
+}
+
+TEST_CASE ("EQ changes ramp instead of jumping", "[dsp]")
+{
+    PluginProcessor p;
+    p.prepareToPlay (48000.0, 4096);
+
+    juce::AudioBuffer<float> buffer (2, 4096);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 4096; ++i)
+            buffer.setSample (ch, i, 1.0f);
+
+    // Low shelf to +12 dB at the very start. On DC the shelf's gain is A^2,
+    // i.e. x4, but the ramp gets there over ~20 ms rather than immediately.
+    p.queueParameterEvent (PluginProcessor::bandParameterIndex (0, PluginProcessor::BandParameter::Gain), 0, 1.0f);
+
+    juce::MidiBuffer midi;
+    p.processBlock (buffer, midi);
+
+    CHECK (buffer.getSample (0, 64) < 1.0f);
+    CHECK (buffer.getSample (0, 4095) == Catch::Approx (2.0f).margin (0.05f));
+}
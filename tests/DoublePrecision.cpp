@@ -0,0 +1,108 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr double sampleRate = 192000.0;
+    constexpr int blockSize     = 512;
+    constexpr int numSamples    = 192000;
+
+    std::vector<double> makeNoise()
+    {
+        std::vector<double> x ((size_t) numSamples);
+        juce::Random random (11);
+        for (auto& s : x)
+            s = random.nextDouble() - 0.5;
+        return x;
+    }
+
+    void setParameter (PluginProcessor& p, const juce::String& id, float value)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    // Runs the processor in the given precision over the noise, on the left
+    // channel of a stereo bus, and returns what came out in double
+    template <typename SampleType>
+    std::vector<double> render (const std::vector<double>& input)
+    {
+        PluginProcessor p;
+        setParameter (p, "lowFreq", 20.0f);
+        setParameter (p, "lowGain", 12.0f);
+
+        if constexpr (std::is_same_v<SampleType, double>)
+            p.setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+
+        p.prepareToPlay (sampleRate, blockSize);
+
+        std::vector<double> output ((size_t) numSamples);
+        juce::AudioBuffer<SampleType> buffer (2, blockSize);
+        juce::MidiBuffer midi;
+
+        for (int position = 0; position < numSamples; position += blockSize)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample (ch, i, static_cast<SampleType> (input[(size_t) (position + i)]));
+
+            p.processBlock (buffer, midi);
+
+            for (int i = 0; i < blockSize; ++i)
+                output[(size_t) (position + i)] = buffer.getSample (0, i);
+        }
+
+        return output;
+    }
+
+    double errorDb (const std::vector<double>& output, const std::vector<double>& reference)
+    {
+        double error = 0.0, signal = 0.0;
+        for (size_t i = 0; i < output.size(); ++i)
+        {
+            error += (output[i] - reference[i]) * (output[i] - reference[i]);
+            signal += reference[i] * reference[i];
+        }
+
+        return 10.0 * std::log10 (error / signal);
+    }
+}
+
+TEST_CASE ("Double precision processing lowers the noise floor of a low shelf", "[dsp][precision]")
+{
+    // 20 Hz low shelf at 192 kHz, the worst case for the float direct form
+    const auto input = makeNoise();
+
+    BiquadCascade<double, 1, 1> shelf;
+    shelf.setCoefficients (0, FilterDesign::makeLowShelf (sampleRate, 20.0, 12.0, 0.707));
+
+    // Default master gain is 0.5; the other bands sit at 0 dB
+    auto reference = input;
+    double* const rp[] = { reference.data() };
+    shelf.process (rp, 1, numSamples, [] { return 0.5; });
+
+    const auto floatError  = errorDb (render<float> (input), reference);
+    const auto doubleError = errorDb (render<double> (input), reference);
+
+    CHECK (doubleError < -120.0);
+    CHECK (doubleError < floatError - 30.0);
+}
+
+TEST_CASE ("Double precision processing touches every channel", "[dsp][precision]")
+{
+    PluginProcessor p;
+    p.setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+    p.prepareToPlay (48000.0, blockSize);
+
+    juce::AudioBuffer<double> buffer (2, blockSize);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            buffer.setSample (ch, i, 1.0);
+
+    juce::MidiBuffer midi;
+    p.processBlock (buffer, midi);
+
+    // Flat EQ, so the output is just the default master gain
+    for (int ch = 0; ch < 2; ++ch)
+        CHECK (std::abs (buffer.getSample (ch, blockSize - 1) - 0.5) < 1.0e-9);
+}
@@ -0,0 +1,97 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr std::array<BandType, 3> bandTypes { BandType::LowShelf, BandType::PeakBell, BandType::HighShelf };
+
+    using Chain = EqChain<float, BiquadTopology, 3>;
+
+    // Flat chain with the bell at 1 kHz; only the bell may be dynamic
+    Chain makeChain()
+    {
+        Chain eq { bandTypes };
+        eq.prepare (sampleRate);
+        eq.snapBand (0, 100.0f, 0.0f, 0.707f);
+        eq.snapBand (1, 1000.0f, 0.0f, 1.0f);
+        eq.snapBand (2, 10000.0f, 0.0f, 0.707f);
+        return eq;
+    }
+
+    // Steady stereo sine at amplitude, half a second of it
+    std::vector<float> runSine (Chain& eq, float freq, float amplitude)
+    {
+        constexpr int numSamples = 24000;
+        std::vector<float> left ((size_t) numSamples), right ((size_t) numSamples);
+        for (size_t i = 0; i < left.size(); ++i)
+            left[i] = right[i] = amplitude * (float) std::sin (juce::MathConstants<double>::twoPi * freq * (double) i / sampleRate);
+
+        float* const channels[] = { left.data(), right.data() };
+        for (int position = 0; position < numSamples; position += 480)
+        {
+            float* const block[] = { channels[0] + position, channels[1] + position };
+            eq.process (block, 2, 480, [] { return 1.0f; });
+        }
+
+        return left;
+    }
+
+    float tailPeak (const std::vector<float>& x)
+    {
+        float p = 0.0f;
+        for (size_t i = x.size() - 4800; i < x.size(); ++i)
+            p = std::max (p, std::abs (x[i]));
+        return p;
+    }
+}
+
+TEST_CASE ("Dynamic band follows threshold and ratio", "[dsp]")
+{
+    // A -6 dB tone 14 dB over a -20 dB threshold at 2:1 settles 7 dB down
+    auto eq = makeChain();
+    eq.setDynamics (1, true, -20.0f, 2.0f);
+    const auto out = runSine (eq, 1000.0f, 0.5f);
+
+    CHECK (eq.getReductionDb (1) == Catch::Approx (7.0f).margin (0.5f));
+    CHECK (tailPeak (out) == Catch::Approx (0.5f * juce::Decibels::decibelsToGain (-7.0f)).epsilon (0.06f));
+
+    // Static bands are never touched
+    CHECK (eq.getReductionDb (0) == 0.0f);
+    CHECK (eq.getReductionDb (2) == 0.0f);
+}
+
+TEST_CASE ("Dynamic band leaves signals under the threshold alone", "[dsp]")
+{
+    auto eq = makeChain();
+    eq.setDynamics (1, true, -20.0f, 4.0f);
+    const auto out = runSine (eq, 1000.0f, 0.05f);
+
+    CHECK (eq.getReductionDb (1) == 0.0f);
+    CHECK (tailPeak (out) == Catch::Approx (0.05f).epsilon (0.01f));
+}
+
+TEST_CASE ("Dynamic band only hears its own part of the spectrum", "[dsp]")
+{
+    // A loud tone three octaves below the bell hardly reaches its sidechain
+    auto eq = makeChain();
+    eq.setDynamics (1, true, -20.0f, 4.0f);
+    runSine (eq, 125.0f, 0.5f);
+
+    CHECK (eq.getReductionDb (1) < 1.0f);
+}
+
+TEST_CASE ("Switching a band back to static restores its set gain", "[dsp]")
+{
+    auto eq = makeChain();
+    eq.setDynamics (1, true, -40.0f, 10.0f);
+    runSine (eq, 1000.0f, 0.5f);
+    REQUIRE (eq.getReductionDb (1) > 10.0f);
+
+    eq.setDynamics (1, false, -40.0f, 10.0f);
+    const auto out = runSine (eq, 1000.0f, 0.5f);
+
+    CHECK (eq.getReductionDb (1) == 0.0f);
+    CHECK (tailPeak (out) == Catch::Approx (0.5f).epsilon (0.01f));
+}
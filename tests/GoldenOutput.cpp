@@ -0,0 +1,377 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <functional>
+#include <optional>
+
+// Renders fixed signals through the whole processor and holds the result
+// against reference files in tests/golden, so a rewrite of the filter path
+// can't change the sound without someone noticing.
+//
+//   MOJOPUNCH_GOLDEN_TOLERANCE  "exact" for bit-exact, otherwise the largest
+//                               difference allowed in dBFS (default -100)
+//   MOJOPUNCH_UPDATE_GOLDEN=1   write every reference from this build
+//   MOJOPUNCH_GOLDEN_DIR        read and write references there instead
+//
+// Nothing is written without MOJOPUNCH_UPDATE_GOLDEN. A band count with no
+// references yet is skipped, not passed, and one missing from a recorded set
+// fails, so nothing passes by comparing nothing.
+
+namespace
+{
+    constexpr int length = 4096, referenceBlockSize = 512;
+    constexpr double sampleRates[] = { 44100.0, 96000.0 };
+
+    using Band = PluginProcessor::BandParameter;
+
+    void setParameter (PluginProcessor& p, int index, float value)
+    {
+        auto* param = p.apvts.getParameter (PluginProcessor::getParameterID (index));
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    void setChoice (PluginProcessor& p, const juce::String& id, int choice)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 ((float) choice));
+    }
+
+    constexpr int lowBand = 0, bellBand = PluginProcessor::numBands / 2, highBand = PluginProcessor::numBands - 1;
+
+    struct Setup
+    {
+        const char* name;
+        int numChannels;
+        std::function<void (PluginProcessor&)> apply;
+    };
+
+    // Plain biquads in mono, then the heavier paths together in stereo
+    const Setup setups[] = {
+        { "shaped", 1, [] (PluginProcessor& p) {
+             setParameter (p, PluginProcessor::bandParameterIndex (lowBand, Band::Gain), 6.0f);
+             setParameter (p, PluginProcessor::bandParameterIndex (bellBand, Band::Gain), -4.0f);
+             setParameter (p, PluginProcessor::bandParameterIndex (bellBand, Band::Q), 2.0f);
+             setParameter (p, PluginProcessor::bandParameterIndex (highBand, Band::Gain), 3.0f);
+             setParameter (p, PluginProcessor::MasterGain, 0.8f);
+         } },
+        { "dynamic-ms-svf-2x", 2, [] (PluginProcessor& p) {
+             setChoice (p, "filterTopology", 1);
+             setChoice (p, "oversampling", 1);
+             setChoice (p, "stereoMode", 1);
+             setParameter (p, PluginProcessor::bandParameterIndex (bellBand, Band::Gain), 9.0f);
+             setParameter (p, PluginProcessor::bandParameterIndex (bellBand, Band::Q), 4.0f);
+             setParameter (p, PluginProcessor::bandParameterIndex (bellBand, Band::Dynamic), 1.0f);
+             setParameter (p, PluginProcessor::bandParameterIndex (bellBand, Band::Threshold), -30.0f);
+             setParameter (p, PluginProcessor::bandParameterIndex (bellBand, Band::Ratio), 4.0f);
+             setParameter (p, PluginProcessor::bandParameterIndex (lowBand, Band::Gain, 1), -6.0f);
+             setParameter (p, PluginProcessor::Attack, 6.0f);
+         } },
+    };
+
+    enum class Signal { Impulse, Sweep, Noise, Automation };
+
+    struct SignalInfo
+    {
+        Signal signal;
+        const char* name;
+    };
+
+    constexpr SignalInfo signals[] = {
+        { Signal::Impulse, "impulse" },
+        { Signal::Sweep, "sweep" },
+        { Signal::Noise, "noise" },
+        { Signal::Automation, "automation" },
+    };
+
+    // Channels after the first get quieter copies, or their own noise, so
+    // the side signal isn't empty
+    juce::AudioBuffer<float> makeInput (Signal signal, int numChannels, double sampleRate)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, length);
+        buffer.clear();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* data = buffer.getWritePointer (ch);
+            const auto level = 1.0f - 0.4f * (float) ch;
+
+            switch (signal)
+            {
+                case Signal::Impulse:
+                    data[64] = 0.5f * level;
+                    break;
+
+                case Signal::Sweep:
+                {
+                    // Exponential, 20 Hz up to 0.45 of the rate
+                    const double f0 = 20.0, f1 = 0.45 * sampleRate, seconds = length / sampleRate;
+                    const double k = std::log (f1 / f0);
+                    for (int i = 0; i < length; ++i)
+                    {
+                        const double t = i / sampleRate;
+                        const double phase = juce::MathConstants<double>::twoPi * f0 * seconds / k * (std::exp (t / seconds * k) - 1.0);
+                        data[i] = 0.5f * level * (float) std::sin (phase);
+                    }
+                    break;
+                }
+
+                case Signal::Noise:
+                {
+                    juce::Random random (1234 + ch);
+                    for (int i = 0; i < length; ++i)
+                        data[i] = 0.5f * level * (2.0f * random.nextFloat() - 1.0f);
+                    break;
+                }
+
+                case Signal::Automation:
+                    for (int i = 0; i < length; ++i)
+                        data[i] = 0.25f * level * (float) std::sin (juce::MathConstants<double>::twoPi * 1000.0 * i / sampleRate);
+                    break;
+            }
+        }
+
+        return buffer;
+    }
+
+    struct TimedEvent
+    {
+        int position;
+        int parameterIndex;
+        float normalisedValue;
+    };
+
+    // Stepped ramps on the bell's gain and frequency and on the master gain,
+    // stamped at absolute positions, in order
+    std::vector<TimedEvent> makeAutomation (Signal signal)
+    {
+        std::vector<TimedEvent> events;
+        if (signal != Signal::Automation)
+            return events;
+
+        for (int step = 0, position = 100; position < length; ++step, position += 64)
+        {
+            const auto ramp = (float) position / (float) length;
+            events.push_back ({ position, PluginProcessor::bandParameterIndex (bellBand, Band::Gain), ramp });
+
+            if (step % 4 == 0)
+            {
+                events.push_back ({ position, PluginProcessor::bandParameterIndex (bellBand, Band::Freq), 1.0f - ramp });
+                events.push_back ({ position, PluginProcessor::MasterGain, 0.5f + 0.5f * ramp });
+            }
+        }
+
+        return events;
+    }
+
+    // Block sizes come from nextBlockSize, so a case can vary them as a host does
+    juce::AudioBuffer<float> render (const Setup& setup, Signal signal, double sampleRate, const std::function<int()>& nextBlockSize)
+    {
+        PluginProcessor p;
+
+        const auto set = juce::AudioChannelSet::canonicalChannelSet (setup.numChannels);
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (set);
+        layout.inputBuses.add (juce::AudioChannelSet::disabled()); // no sidechain
+        layout.outputBuses.add (set);
+        REQUIRE (p.setBusesLayout (layout));
+
+        setup.apply (p);
+        p.prepareToPlay (sampleRate, length);
+
+        auto buffer = makeInput (signal, setup.numChannels, sampleRate);
+        const auto events = makeAutomation (signal);
+        auto nextEvent = events.begin();
+        juce::MidiBuffer midi;
+
+        for (int position = 0; position < length;)
+        {
+            const int numSamples = juce::jmin (nextBlockSize(), length - position);
+
+            for (; nextEvent != events.end() && nextEvent->position < position + numSamples; ++nextEvent)
+                p.queueParameterEvent (nextEvent->parameterIndex, nextEvent->position - position, nextEvent->normalisedValue);
+
+            juce::AudioBuffer<float> block (buffer.getArrayOfWritePointers(), setup.numChannels, position, numSamples);
+            p.processBlock (block, midi);
+            position += numSamples;
+        }
+
+        return buffer;
+    }
+
+    juce::AudioBuffer<float> renderFixed (const Setup& setup, Signal signal, double sampleRate, int blockSize)
+    {
+        return render (setup, signal, sampleRate, [blockSize] { return blockSize; });
+    }
+
+    //==============================================================================
+    // A negative tolerance means bit-exact
+    double tolerance()
+    {
+        const auto setting = juce::SystemStats::getEnvironmentVariable ("MOJOPUNCH_GOLDEN_TOLERANCE", "-100");
+        if (setting.trim().equalsIgnoreCase ("exact"))
+            return -1.0;
+        return juce::Decibels::decibelsToGain (setting.getDoubleValue());
+    }
+
+    struct Difference
+    {
+        double largest = 0.0;
+        int channel = -1, sample = -1;
+        bool identical = true;
+    };
+
+    Difference compare (const juce::AudioBuffer<float>& expected, const juce::AudioBuffer<float>& actual)
+    {
+        Difference result;
+        for (int ch = 0; ch < expected.getNumChannels(); ++ch)
+        {
+            for (int i = 0; i < expected.getNumSamples(); ++i)
+            {
+                const auto a = expected.getSample (ch, i), b = actual.getSample (ch, i);
+                if (std::memcmp (&a, &b, sizeof (float)) == 0)
+                    continue;
+
+                result.identical = false;
+                const auto diff = std::abs ((double) a - (double) b);
+                if (! (diff <= result.largest)) // NaN counts as the largest
+                {
+                    result.largest = std::isnan (diff) ? std::numeric_limits<double>::infinity() : diff;
+                    result.channel = ch;
+                    result.sample  = i;
+                }
+            }
+        }
+        return result;
+    }
+
+    bool matches (const Difference& difference)
+    {
+        const auto allowed = tolerance();
+        return allowed < 0.0 ? difference.identical : difference.largest <= allowed;
+    }
+
+    juce::String describe (const Difference& difference)
+    {
+        if (difference.identical)
+            return "identical";
+        return "largest difference " + juce::String (juce::Decibels::gainToDecibels (difference.largest, -400.0), 1)
+             + " dBFS on channel " + juce::String (difference.channel) + " at sample " + juce::String (difference.sample);
+    }
+
+    //==============================================================================
+    // tests/golden in the source tree, absolute since tests run from the
+    // build tree, unless MOJOPUNCH_GOLDEN_DIR says otherwise
+    juce::File goldenDirectory()
+    {
+        const auto custom = juce::SystemStats::getEnvironmentVariable ("MOJOPUNCH_GOLDEN_DIR", {});
+        const auto root   = custom.isNotEmpty() ? juce::File::getCurrentWorkingDirectory().getChildFile (custom)
+                                                : juce::File (__FILE__).getSiblingFile ("golden");
+
+        return root.getChildFile (juce::String (PluginProcessor::numBands) + "-band");
+    }
+
+    juce::File referenceFile (const Setup& setup, const SignalInfo& signal, double sampleRate)
+    {
+        return goldenDirectory().getChildFile (juce::String (setup.name) + "_" + signal.name + "_"
+                                               + juce::String ((int) sampleRate) + ".wav");
+    }
+
+    bool writeReference (const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        auto stream = std::make_unique<juce::FileOutputStream> (file);
+        if (! stream->openedOk())
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (stream.get(), sampleRate, (unsigned int) buffer.getNumChannels(), 32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // the writer owns it now
+        return writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+    }
+
+    std::optional<juce::AudioBuffer<float>> readReference (const juce::File& file)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader (wav.createReaderFor (file.createInputStream().release(), true));
+        if (reader == nullptr)
+            return std::nullopt;
+
+        juce::AudioBuffer<float> buffer ((int) reader->numChannels, (int) reader->lengthInSamples);
+        reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+        return buffer;
+    }
+}
+
+TEST_CASE ("Output matches the golden references", "[golden]")
+{
+    const bool update = juce::SystemStats::getEnvironmentVariable ("MOJOPUNCH_UPDATE_GOLDEN", {}).getIntValue() != 0;
+
+    if (! update && goldenDirectory().getNumberOfChildFiles (juce::File::findFiles, "*.wav") == 0)
+        SKIP ("No references in " << goldenDirectory().getFullPathName() << " yet, record them with MOJOPUNCH_UPDATE_GOLDEN=1");
+
+    for (const auto& setup : setups)
+        for (const auto& signal : signals)
+            for (const auto sampleRate : sampleRates)
+            {
+                const auto file = referenceFile (setup, signal, sampleRate);
+                INFO (file.getFileName());
+
+                const auto output = renderFixed (setup, signal.signal, sampleRate, referenceBlockSize);
+
+                if (update)
+                {
+                    REQUIRE (writeReference (file, output, sampleRate));
+                    WARN ("Wrote " << file.getFullPathName() << ", commit it");
+                    continue;
+                }
+
+                if (! file.existsAsFile())
+                {
+                    FAIL_CHECK ("No reference at " << file.getFullPathName() << ", record it with MOJOPUNCH_UPDATE_GOLDEN=1");
+                    continue;
+                }
+
+                const auto reference = readReference (file);
+                REQUIRE (reference.has_value());
+                REQUIRE (reference->getNumChannels() == output.getNumChannels());
+                REQUIRE (reference->getNumSamples() == output.getNumSamples());
+
+                const auto difference = compare (*reference, output);
+                INFO (describe (difference));
+                CHECK (matches (difference));
+            }
+}
+
+TEST_CASE ("Block size doesn't change the output", "[golden]")
+{
+    // Sample-accurate automation and a fixed control-rate grid should make
+    // any split of the same audio sound the same
+    const int fixedSizes[] = { 1, 13, 64, 333, length };
+
+    for (const auto& setup : setups)
+        for (const auto& signal : signals)
+        {
+            constexpr double sampleRate = 48000.0;
+            INFO (setup.name << ", " << signal.name);
+
+            const auto reference = renderFixed (setup, signal.signal, sampleRate, referenceBlockSize);
+
+            for (const auto blockSize : fixedSizes)
+            {
+                INFO ("block size " << blockSize);
+                const auto difference = compare (reference, renderFixed (setup, signal.signal, sampleRate, blockSize));
+                INFO (describe (difference));
+                CHECK (matches (difference));
+            }
+
+            // Sizes that change every block, as some hosts send them
+            juce::Random random (42);
+            const auto difference = compare (reference, render (setup, signal.signal, sampleRate, [&random] { return 1 + random.nextInt (700); }));
+            INFO ("varying block sizes, " << describe (difference));
+            CHECK (matches (difference));
+        }
+}
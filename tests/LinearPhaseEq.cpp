@@ -0,0 +1,146 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    using Engine = LinearPhaseEq<3>;
+
+    constexpr std::array<BandType, 3> bandTypes { BandType::LowShelf, BandType::PeakBell, BandType::HighShelf };
+    constexpr Engine::Curve flatCurve { { { 200.0f, 0.0f, 0.707f }, { 1000.0f, 0.0f, 1.0f }, { 8000.0f, 0.0f, 0.707f } } };
+    constexpr Engine::Curve testCurve { { { 200.0f, 6.0f, 0.707f }, { 1000.0f, -6.0f, 1.0f }, { 8000.0f, 3.0f, 0.707f } } };
+
+    // Impulse response of the engine, fed in uneven chunks
+    std::vector<float> impulseResponse (Engine& engine, int length)
+    {
+        std::vector<float> data ((size_t) length, 0.0f);
+        data[0] = 1.0f;
+
+        const int chunkSizes[] { 1, 17, 300, 1000, 5 };
+        for (int position = 0, chunk = 0; position < length; ++chunk)
+        {
+            const int numSamples = juce::jmin (length - position, chunkSizes[chunk % 5]);
+            float* const channels[] { data.data() + position };
+            engine.process (channels, 1, numSamples);
+            position += numSamples;
+        }
+
+        return data;
+    }
+
+    double magnitudeDb (const std::vector<float>& h, double freq, double sampleRate)
+    {
+        std::complex<double> sum;
+        for (size_t n = 0; n < h.size(); ++n)
+            sum += (double) h[n] * std::polar (1.0, -juce::MathConstants<double>::twoPi * freq * (double) n / sampleRate);
+        return juce::Decibels::gainToDecibels (std::abs (sum), -200.0);
+    }
+}
+
+TEST_CASE ("Linear-phase EQ on a flat curve is a pure delay", "[dsp][linearphase]")
+{
+    Engine engine (bandTypes);
+    engine.prepare (48000.0, 48000.0, 1, flatCurve);
+
+    const int latency = engine.getLatencySamples();
+    const auto h = impulseResponse (engine, latency * 2);
+
+    for (int n = 0; n < (int) h.size(); ++n)
+        REQUIRE (h[(size_t) n] == Catch::Approx (n == latency ? 1.0f : 0.0f).margin (1.0e-5));
+}
+
+TEST_CASE ("Linear-phase EQ matches the minimum-phase magnitude", "[dsp][linearphase]")
+{
+    constexpr double sampleRate = 48000.0;
+
+    Engine engine (bandTypes);
+    engine.prepare (sampleRate, sampleRate, 1, testCurve);
+
+    const int latency = engine.getLatencySamples();
+    const auto h = impulseResponse (engine, latency * 2 + 1);
+
+    // Symmetric around the latency, i.e. linear phase
+    for (int n = 1; n < latency - Engine::partitionSize; ++n)
+        REQUIRE (h[(size_t) (latency - n)] == Catch::Approx (h[(size_t) (latency + n)]).margin (1.0e-6));
+
+    for (const double freq : { 50.0, 200.0, 500.0, 1000.0, 3000.0, 8000.0, 15000.0 })
+    {
+        auto expected = 0.0;
+        for (size_t band = 0; band < bandTypes.size(); ++band)
+        {
+            const auto& b = testCurve[band];
+            const auto c  = FilterDesign::makeBand (bandTypes[band], sampleRate, (double) b.freq, (double) b.gainDb, (double) b.q);
+            juce::dsp::IIR::Coefficients<double> coeffs (c.b0, c.b1, c.b2, 1.0, c.a1, c.a2);
+            expected += juce::Decibels::gainToDecibels (coeffs.getMagnitudeForFrequency (freq, sampleRate));
+        }
+
+        CHECK (magnitudeDb (h, freq, sampleRate) == Catch::Approx (expected).margin (0.05));
+    }
+}
+
+TEST_CASE ("Linear-phase kernels are rebuilt in the background", "[dsp][linearphase]")
+{
+    Engine engine (bandTypes);
+    engine.prepare (48000.0, 48000.0, 1, flatCurve);
+    REQUIRE_FALSE (engine.isKernelPending());
+
+    engine.requestCurve (testCurve, 48000.0);
+    CHECK (engine.isKernelPending());
+
+    // The new kernel is picked up at a partition boundary once it's built
+    std::array<float, Engine::partitionSize> silence {};
+    for (int attempt = 0; attempt < 500 && engine.isKernelPending(); ++attempt)
+    {
+        float* const channels[] { silence.data() };
+        engine.process (channels, 1, (int) silence.size());
+        juce::Thread::sleep (2);
+    }
+
+    CHECK_FALSE (engine.isKernelPending());
+}
+
+TEST_CASE ("Linear phase mode reports the engine's latency", "[linearphase]")
+{
+    PluginProcessor p;
+    auto* phaseMode = p.apvts.getParameter ("phaseMode");
+    phaseMode->setValueNotifyingHost (phaseMode->convertTo0to1 ((float) PluginProcessor::PhaseMode::Linear));
+
+    p.prepareToPlay (48000.0, 512);
+
+    Engine reference (bandTypes);
+    reference.prepare (48000.0, 48000.0, 1, flatCurve);
+    CHECK (p.getLatencySamples() == reference.getLatencySamples());
+}
+
+TEST_CASE ("Switching phase mode while playing reports latency from the message thread", "[linearphase]")
+{
+    PluginProcessor p;
+    auto* phaseMode = p.apvts.getParameter ("phaseMode");
+    auto setPhaseMode = [&] (PluginProcessor::PhaseMode mode) {
+        phaseMode->setValueNotifyingHost (phaseMode->convertTo0to1 ((float) mode));
+    };
+
+    // Starting in linear phase builds the engine, which then stays built
+    setPhaseMode (PluginProcessor::PhaseMode::Linear);
+    p.prepareToPlay (48000.0, 512);
+    const int linearLatency = p.getLatencySamples();
+    REQUIRE (linearLatency > 0);
+
+    juce::AudioBuffer<float> buffer (2, 512);
+    juce::MidiBuffer midi;
+
+    // The audio thread switches, and only posts the latency
+    setPhaseMode (PluginProcessor::PhaseMode::Minimum);
+    buffer.clear();
+    p.processBlock (buffer, midi);
+    CHECK (p.getLatencySamples() == linearLatency);
+    p.reportLatency();
+    CHECK (p.getLatencySamples() == 0);
+
+    setPhaseMode (PluginProcessor::PhaseMode::Linear);
+    buffer.clear();
+    p.processBlock (buffer, midi);
+    CHECK (p.getLatencySamples() == 0);
+    p.reportLatency();
+    CHECK (p.getLatencySamples() == linearLatency);
+}
@@ -0,0 +1,99 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    juce::AudioProcessor::BusesLayout layoutOf (const juce::AudioChannelSet& set)
+    {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (set);
+        layout.inputBuses.add (juce::AudioChannelSet::disabled()); // no sidechain
+        layout.outputBuses.add (set);
+        return layout;
+    }
+}
+
+TEST_CASE ("EqChain runs every channel group like a lone channel", "[dsp]")
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels   = 11; // leaves the last group part-filled
+    constexpr int numSamples    = 1000;
+    constexpr std::array<BandType, 3> bandTypes { BandType::LowShelf, BandType::PeakBell, BandType::HighShelf };
+
+    auto setUp = [] (auto& eq) {
+        eq.prepare (sampleRate);
+        eq.snapBand (0, 200.0f, 6.0f, 0.707f);
+        eq.snapBand (1, 1000.0f, -4.0f, 2.0f);
+        eq.snapBand (2, 8000.0f, 3.0f, 0.707f);
+        eq.rampBand (1, 2000.0f, 4.0f, 1.0f);
+    };
+
+    EqChain<float, BiquadTopology, 3, 4, 12> wide { bandTypes };
+    setUp (wide);
+
+    std::vector<std::vector<float>> input ((size_t) numChannels, std::vector<float> ((size_t) numSamples));
+    juce::Random random (11);
+    for (auto& channel : input)
+        for (auto& x : channel)
+            x = random.nextFloat() * 2.0f - 1.0f;
+
+    // A gain that moves every sample catches any group replaying it out of step
+    auto output = input;
+    std::array<float*, numChannels> channels {};
+    for (size_t ch = 0; ch < channels.size(); ++ch)
+        channels[ch] = output[ch].data();
+
+    float gain = 0.0f;
+    wide.process (channels.data(), numChannels, numSamples, [&gain] { return gain += 0.001f; });
+
+    for (size_t ch = 0; ch < (size_t) numChannels; ++ch)
+    {
+        EqChain<float, BiquadTopology, 3> single { bandTypes };
+        setUp (single);
+
+        auto expected = input[ch];
+        float* const one[] = { expected.data() };
+        float singleGain = 0.0f;
+        single.process (one, 1, numSamples, [&singleGain] { return singleGain += 0.001f; });
+
+        for (size_t i = 0; i < expected.size(); ++i)
+            REQUIRE (output[ch][i] == Catch::Approx (expected[i]).margin (1.0e-6));
+    }
+}
+
+TEST_CASE ("Plugin takes layouts from mono up to 7.1.4", "[instance]")
+{
+    PluginProcessor p;
+
+    CHECK (p.isBusesLayoutSupported (layoutOf (juce::AudioChannelSet::mono())));
+    CHECK (p.isBusesLayoutSupported (layoutOf (juce::AudioChannelSet::stereo())));
+    CHECK (p.isBusesLayoutSupported (layoutOf (juce::AudioChannelSet::create5point1())));
+    CHECK (p.isBusesLayoutSupported (layoutOf (juce::AudioChannelSet::create7point1point4())));
+    CHECK_FALSE (p.isBusesLayoutSupported (layoutOf (juce::AudioChannelSet::discreteChannels (13))));
+}
+
+TEST_CASE ("Every channel of a 7.1.4 bus is processed", "[dsp]")
+{
+    PluginProcessor p;
+    REQUIRE (p.setBusesLayout (layoutOf (juce::AudioChannelSet::create7point1point4())));
+
+    auto* lowGain = p.apvts.getParameter (PluginProcessor::getParameterID (PluginProcessor::bandParameterIndex (0, PluginProcessor::BandParameter::Gain)));
+    lowGain->setValueNotifyingHost (lowGain->convertTo0to1 (6.0f));
+    p.prepareToPlay (48000.0, 512);
+
+    juce::AudioBuffer<float> buffer (12, 512);
+    buffer.clear();
+    for (int ch = 0; ch < 12; ++ch)
+        buffer.setSample (ch, 0, 1.0f);
+
+    juce::MidiBuffer midi;
+    p.processBlock (buffer, midi);
+
+    // Same input everywhere, so every channel comes out like the first
+    for (int ch = 1; ch < 12; ++ch)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+            REQUIRE (buffer.getSample (ch, i) == buffer.getSample (0, i));
+
+    CHECK (buffer.getSample (0, 0) != 0.5f);
+}
@@ -0,0 +1,93 @@
+#include <OfflineRender.h>
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    void setParameter (PluginProcessor& p, const juce::String& id, float value)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    // An impulse at impulsePosition, as a float WAV in memory
+    juce::MemoryBlock makeImpulseFile (int numChannels, int length, int impulsePosition)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, length);
+        buffer.clear();
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.setSample (ch, impulsePosition, 0.5f);
+
+        juce::MemoryBlock data;
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (new juce::MemoryOutputStream (data, false), 48000.0, (unsigned int) numChannels, 32, {}, 0));
+        REQUIRE (writer != nullptr);
+        writer->writeFromAudioSampleBuffer (buffer, 0, length);
+        return data;
+    }
+
+    juce::AudioBuffer<float> renderThrough (PluginProcessor& p, const juce::MemoryBlock& input, int blockSize)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader (wav.createReaderFor (new juce::MemoryInputStream (input, false), true));
+        REQUIRE (reader != nullptr);
+        REQUIRE (OfflineRender::setChannels (p, (int) reader->numChannels));
+
+        juce::MemoryBlock output;
+        {
+            std::unique_ptr<juce::AudioFormatWriter> writer (wav.createWriterFor (new juce::MemoryOutputStream (output, false), reader->sampleRate, reader->numChannels, 32, {}, 0));
+            REQUIRE (OfflineRender::render (p, *reader, *writer, blockSize));
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> rendered (wav.createReaderFor (new juce::MemoryInputStream (output, false), true));
+        REQUIRE (rendered != nullptr);
+
+        juce::AudioBuffer<float> result ((int) rendered->numChannels, (int) rendered->lengthInSamples);
+        rendered->read (&result, 0, result.getNumSamples(), 0, true, true);
+        return result;
+    }
+
+    int peakPosition (const juce::AudioBuffer<float>& buffer, int channel)
+    {
+        const auto* data = buffer.getReadPointer (channel);
+        return (int) (std::max_element (data, data + buffer.getNumSamples(), [] (float a, float b) { return std::abs (a) < std::abs (b); }) - data);
+    }
+}
+
+TEST_CASE ("Offline renders keep the input's length and timing", "[render]")
+{
+    constexpr int length = 48000, impulseAt = 1000;
+
+    PluginProcessor p;
+    setParameter (p, "midGain", 6.0f);
+
+    SECTION ("Minimum phase, stereo, blocks that don't divide the file")
+    {
+        const auto result = renderThrough (p, makeImpulseFile (2, length, impulseAt), 4000 - 3);
+        CHECK (result.getNumChannels() == 2);
+        CHECK (result.getNumSamples() == length);
+        CHECK (peakPosition (result, 0) == impulseAt);
+        CHECK (peakPosition (result, 1) == impulseAt);
+    }
+
+    SECTION ("Linear phase, whose latency is taken back out")
+    {
+        setParameter (p, "phaseMode", 1.0f);
+
+        const auto result = renderThrough (p, makeImpulseFile (1, length, impulseAt), 8192);
+        REQUIRE (p.getLatencySamples() > 0);
+        CHECK (result.getNumSamples() == length);
+        CHECK (peakPosition (result, 0) == impulseAt);
+    }
+
+    SECTION ("An impulse near the end still comes out in full")
+    {
+        setParameter (p, "phaseMode", 1.0f);
+
+        const auto early = renderThrough (p, makeImpulseFile (1, length, impulseAt), 8192);
+        const auto late  = renderThrough (p, makeImpulseFile (1, length, length - 10), 8192);
+        CHECK (peakPosition (late, 0) == length - 10);
+        CHECK (late.getSample (0, length - 10) == Catch::Approx (early.getSample (0, impulseAt)).margin (1.0e-4));
+    }
+}
@@ -0,0 +1,142 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    juce::AudioBuffer<float> makeDC (int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (2, numSamples);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (ch, i, 1.0f);
+        return buffer;
+    }
+}
+
+TEST_CASE ("ParameterEventQueue keeps events in order", "[params]")
+{
+    ParameterEventQueue queue (4);
+
+    CHECK (queue.isEmpty());
+    CHECK (queue.nextOffset (512) == 512);
+
+    REQUIRE (queue.push ({ 1, 10, 0.25f }));
+    REQUIRE (queue.push ({ 2, 20, 0.5f }));
+    CHECK (queue.nextOffset (512) == 10);
+    CHECK (queue.nextOffset (5) == 5);
+
+    ParameterEvent event;
+    REQUIRE (queue.peek (event));
+    CHECK (event.parameterIndex == 1);
+    queue.pop();
+
+    REQUIRE (queue.peek (event));
+    CHECK (event.sampleOffset == 20);
+    queue.pop();
+
+    CHECK (queue.isEmpty());
+}
+
+TEST_CASE ("Master gain event lands on its sample offset", "[params][dsp]")
+{
+    PluginProcessor p;
+    p.prepareToPlay (48000.0, 1024);
+
+    auto buffer = makeDC (1024);
+    juce::MidiBuffer midi;
+
+    p.queueParameterEvent (PluginProcessor::MasterGain, 600, 1.0f);
+    p.processBlock (buffer, midi);
+
+    // Default master gain is 0.5 and every EQ band is flat
+    CHECK (buffer.getSample (0, 0) == Catch::Approx (0.5f).margin (1.0e-4));
+    CHECK (buffer.getSample (0, 599) == Catch::Approx (0.5f).margin (1.0e-4));
+    CHECK (buffer.getSample (0, 600) > 0.5001f);
+    CHECK (buffer.getSample (1, 1023) > 0.55f);
+
+    // The parameter itself has moved. The host sent it, so it isn't told
+    // back; the editor polls for host changes.
+    CHECK (p.apvts.getParameter ("masterGain")->getValue() == Catch::Approx (1.0f));
+}
+
+TEST_CASE ("EQ event only affects samples after its offset", "[params][dsp]")
+{
+    PluginProcessor p;
+    p.prepareToPlay (48000.0, 1024);
+
+    auto buffer = makeDC (1024);
+    juce::MidiBuffer midi;
+
+    // Low shelf to +12 dB half way through the block
+    p.queueParameterEvent (PluginProcessor::bandParameterIndex (0, PluginProcessor::BandParameter::Gain), 512, 1.0f);
+    p.processBlock (buffer, midi);
+
+    CHECK (buffer.getSample (0, 511) == Catch::Approx (0.5f).margin (1.0e-4));
+    CHECK (buffer.getSample (0, 1023) > 0.6f);
+}
+
+TEST_CASE ("CLAP parameter events reach every parameter", "[params]")
+{
+    PluginProcessor p;
+    p.prepareToPlay (48000.0, 1024);
+
+    auto paramEvent = [] (const juce::String& id, double value) {
+        clap_event_param_value_t event {};
+        event.header.size     = sizeof (event);
+        event.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+        event.header.type     = CLAP_EVENT_PARAM_VALUE;
+        event.param_id        = static_cast<clap_id> (id.hashCode());
+        event.value           = value;
+        return event;
+    };
+
+    REQUIRE (p.supportsDirectEvent (CLAP_CORE_EVENT_SPACE_ID, CLAP_EVENT_PARAM_VALUE));
+    const auto changes = p.getHostChangeCount();
+
+    // An automatable parameter is queued for the next block...
+    const auto gain = paramEvent ("masterGain", 1.0);
+    p.handleDirectEvent (&gain.header, 0);
+    CHECK (p.apvts.getParameter ("masterGain")->getValue() == Catch::Approx (0.5f));
+
+    auto buffer = makeDC (1024);
+    juce::MidiBuffer midi;
+    p.processBlock (buffer, midi);
+    CHECK (p.apvts.getParameter ("masterGain")->getValue() == Catch::Approx (1.0f));
+
+    // ...and a switch, which isn't automatable, is set straight away. The
+    // next block goes by it without waiting for the message thread.
+    const auto topology = paramEvent ("filterTopology", 1.0);
+    p.handleDirectEvent (&topology.header, 0);
+    CHECK (p.apvts.getParameter ("filterTopology")->getValue() == Catch::Approx (1.0f));
+
+    const auto oversampling = paramEvent ("oversampling", 1.0);
+    p.handleDirectEvent (&oversampling.header, 0);
+    p.processBlock (buffer, midi);
+    p.reportLatency();
+    CHECK (p.getLatencySamples() > 0);
+
+    // The editor counts every one of them
+    CHECK (p.getHostChangeCount() == changes + 3);
+
+    // Ids that aren't ours are ignored
+    const auto unknown = paramEvent ("notAParameter", 1.0);
+    p.handleDirectEvent (&unknown.header, 0);
+}
+
+TEST_CASE ("A parameter ends on its latest value when the queue overflows", "[params]")
+{
+    PluginProcessor p;
+    p.prepareToPlay (48000.0, 1024);
+
+    // More changes to one parameter than the queue holds
+    constexpr int numEvents = 1500;
+    for (int i = 0; i < numEvents; ++i)
+        p.queueParameterEvent (PluginProcessor::MasterGain, i * 1024 / numEvents, (float) i / (float) (numEvents - 1));
+
+    auto buffer = makeDC (1024);
+    juce::MidiBuffer midi;
+    p.processBlock (buffer, midi);
+
+    CHECK (p.apvts.getParameter ("masterGain")->getValue() == Catch::Approx (1.0f));
+}
@@ -24,7 +24,21 @@ TEST_CASE ("Plugin instance", "[instance]")
 TEST_CASE ("Parameter count", "[params]")
 {
     PluginProcessor p;
-    REQUIRE (p.getParameters().size() == 10);
+    // Plus the six non-automatable switches
+    REQUIRE (p.getParameters().size() == PluginProcessor::NumParameters + 6);
+}
+
+TEST_CASE ("Host parameter order follows ParameterIndex", "[params]")
+{
+    PluginProcessor p;
+    const auto& params = p.getParameters();
+
+    for (int i = 0; i < PluginProcessor::NumParameters; ++i)
+    {
+        const auto* param = dynamic_cast<juce::AudioProcessorParameterWithID*> (params[i]);
+        REQUIRE (param != nullptr);
+        CHECK (param->paramID == PluginProcessor::getParameterID (i));
+    }
 }
 
 TEST_CASE ("State round-trip", "[state]")
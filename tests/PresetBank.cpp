@@ -0,0 +1,143 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr int numPresets = 2000;
+
+    // Each band's gain follows the preset number, in the parameter's 0.1 dB steps
+    float gainFor (int preset, int band) { return -12.0f + 0.1f * (float) ((preset + band * 7) % 241); }
+
+    juce::StringArray allParameterIDs()
+    {
+        juce::StringArray ids;
+        for (int i = 0; i < PluginProcessor::NumParameters; ++i)
+            ids.add (PluginProcessor::getParameterID (i));
+        return ids;
+    }
+
+    // A bank of numPresets presets, every parameter at its default but the gains
+    juce::File writeBank (const juce::TemporaryFile& temp)
+    {
+        PluginProcessor defaults;
+        const auto ids = allParameterIDs();
+
+        std::vector<PresetBank::Preset> presets ((size_t) numPresets);
+        for (int n = 0; n < numPresets; ++n)
+        {
+            auto& preset = presets[(size_t) n];
+            preset.name = "Preset " + juce::String (n);
+
+            for (const auto& id : ids)
+            {
+                auto* param = defaults.apvts.getParameter (id);
+                preset.values.push_back (param->convertFrom0to1 (param->getDefaultValue()));
+            }
+
+            for (int band = 0; band < PluginProcessor::numBands; ++band)
+                preset.values[(size_t) PluginProcessor::bandParameterIndex (band, PluginProcessor::BandParameter::Gain)] = gainFor (n, band);
+        }
+
+        auto file = temp.getFile();
+        {
+            juce::FileOutputStream out (file);
+            REQUIRE (out.openedOk());
+            out.truncate();
+            PresetBank::write (out, ids, presets);
+        }
+        return file;
+    }
+
+    float bandGain (PluginProcessor& p, int band)
+    {
+        auto* param = p.getParameters()[PluginProcessor::bandParameterIndex (band, PluginProcessor::BandParameter::Gain)];
+        return dynamic_cast<juce::RangedAudioParameter*> (param)->convertFrom0to1 (param->getValue());
+    }
+}
+
+TEST_CASE ("Preset banks round-trip through a mapped file", "[presets]")
+{
+    juce::TemporaryFile temp (".mjpb");
+    const auto file = writeBank (temp);
+
+    PresetBank bank;
+    REQUIRE (bank.open (file));
+    CHECK (bank.size() == numPresets);
+    CHECK (bank.getName (1234) == "Preset 1234");
+    CHECK (bank.getName (numPresets).isEmpty());
+
+    const auto gainIndex = PluginProcessor::bandParameterIndex (1, PluginProcessor::BandParameter::Gain);
+    const auto hash      = (juce::uint32) PluginProcessor::getParameterID (gainIndex).hashCode();
+
+    float plain = 0.0f;
+    REQUIRE (bank.find (777, hash, gainIndex, plain));
+    CHECK (plain == gainFor (777, 1));
+
+    // The hint is only where the search starts
+    REQUIRE (bank.find (777, hash, 0, plain));
+    CHECK (plain == gainFor (777, 1));
+    CHECK_FALSE (bank.find (777, 0x12345678, 0, plain));
+}
+
+TEST_CASE ("Files that aren't banks are refused", "[presets]")
+{
+    juce::TemporaryFile temp (".mjpb");
+    temp.getFile().replaceWithText ("not a preset bank");
+
+    PresetBank bank;
+    CHECK_FALSE (bank.open (temp.getFile()));
+    CHECK_FALSE (bank.open (juce::File()));
+    CHECK (bank.size() == 0);
+
+    PluginProcessor p;
+    const auto programs = p.getNumPrograms();
+    CHECK_FALSE (p.loadPresetBank (temp.getFile()));
+    CHECK (p.getNumPrograms() == programs);
+}
+
+TEST_CASE ("Programs come from the preset bank", "[presets][params]")
+{
+    juce::TemporaryFile temp (".mjpb");
+    const auto file = writeBank (temp);
+
+    PluginProcessor p;
+    REQUIRE (p.loadPresetBank (file));
+    CHECK (p.getNumPrograms() == numPresets);
+    CHECK (p.getProgramName (42) == "Preset 42");
+
+    // Loading the bank makes program 0 current
+    CHECK (p.getCurrentProgram() == 0);
+    for (int band = 0; band < PluginProcessor::numBands; ++band)
+        CHECK (bandGain (p, band) == Catch::Approx (gainFor (0, band)).margin (1.0e-3));
+
+    SECTION ("Straight away while not playing")
+    {
+        p.setCurrentProgram (42);
+        CHECK (p.getCurrentProgram() == 42);
+        for (int band = 0; band < PluginProcessor::numBands; ++band)
+            CHECK (bandGain (p, band) == Catch::Approx (gainFor (42, band)).margin (1.0e-3));
+    }
+
+    SECTION ("At the top of the next block while playing")
+    {
+        p.prepareToPlay (48000.0, 64);
+        p.setCurrentProgram (1999);
+        CHECK (bandGain (p, 0) == Catch::Approx (gainFor (0, 0)).margin (1.0e-3));
+
+        juce::AudioBuffer<float> buffer (2, 64);
+        buffer.clear();
+        juce::MidiBuffer midi;
+        p.processBlock (buffer, midi);
+
+        CHECK (p.getCurrentProgram() == 1999);
+        for (int band = 0; band < PluginProcessor::numBands; ++band)
+            CHECK (bandGain (p, band) == Catch::Approx (gainFor (1999, band)).margin (1.0e-3));
+    }
+
+    SECTION ("Out-of-range programs are ignored")
+    {
+        p.setCurrentProgram (numPresets);
+        CHECK (p.getCurrentProgram() == 0);
+    }
+}
@@ -0,0 +1,546 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+#if defined(__linux__) && defined(__GLIBC__)
+    #include <dlfcn.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <time.h>
+    #include <unistd.h>
+#endif
+
+//==============================================================================
+// Test-only audit of the audio thread. While a RealtimeGuard::Scope is alive,
+// every allocation, free, lock and blocking system call made on that thread
+// is logged, and the tests fail on any of them.
+//
+// operator new and delete are replaced everywhere. On glibc the C allocator,
+// pthread locks, sleeps, yields and raw write()s are interposed as well: the
+// executable's definitions win over libc's, so calls from JUCE and the
+// standard library land here too. Other platforms only get the operator new
+// checks.
+namespace RealtimeGuard
+{
+    constexpr int maxLogged = 32;
+
+    // Only string literals go in the log, so reporting never allocates
+    thread_local bool active = false;
+    std::atomic<int> count { 0 };
+    std::array<const char*, maxLogged> logged {};
+
+    void report (const char* what) noexcept
+    {
+        if (! active)
+            return;
+
+        const int n = count.fetch_add (1);
+        if (n < maxLogged)
+            logged[(size_t) n] = what;
+    }
+
+    struct Scope
+    {
+        Scope() noexcept
+        {
+            count  = 0;
+            active = true;
+        }
+
+        ~Scope() { active = false; }
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+    int violations() noexcept { return count.load(); }
+
+    void* allocateAligned (std::size_t size, std::size_t alignment) noexcept
+    {
+       #if JUCE_WINDOWS
+        return _aligned_malloc (size, alignment);
+       #else
+        void* p = nullptr;
+        return posix_memalign (&p, juce::jmax (alignment, sizeof (void*)), size) == 0 ? p : nullptr;
+       #endif
+    }
+
+    void freeAligned (void* p) noexcept
+    {
+       #if JUCE_WINDOWS
+        _aligned_free (p);
+       #else
+        std::free (p);
+       #endif
+    }
+
+    juce::String describe()
+    {
+        juce::StringArray kinds;
+        for (int i = 0; i < juce::jmin (count.load(), maxLogged); ++i)
+            kinds.addIfNotAlreadyThere (logged[(size_t) i]);
+
+        return juce::String (count.load()) + " on the audio thread: " + kinds.joinIntoString (", ");
+    }
+}
+
+//==============================================================================
+void* operator new (std::size_t size)
+{
+    RealtimeGuard::report ("operator new");
+    if (auto* p = std::malloc (size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size) { return operator new (size); }
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeGuard::report ("operator new");
+    return std::malloc (size == 0 ? 1 : size);
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t& tag) noexcept { return operator new (size, tag); }
+
+void* operator new (std::size_t size, std::align_val_t alignment)
+{
+    RealtimeGuard::report ("operator new");
+    if (auto* p = RealtimeGuard::allocateAligned (size == 0 ? 1 : size, (std::size_t) alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t size, std::align_val_t alignment) { return operator new (size, alignment); }
+
+void operator delete (void* p) noexcept
+{
+    if (p != nullptr)
+        RealtimeGuard::report ("operator delete");
+    std::free (p);
+}
+
+void operator delete[] (void* p) noexcept { operator delete (p); }
+void operator delete (void* p, std::size_t) noexcept { operator delete (p); }
+void operator delete[] (void* p, std::size_t) noexcept { operator delete (p); }
+void operator delete (void* p, const std::nothrow_t&) noexcept { operator delete (p); }
+void operator delete[] (void* p, const std::nothrow_t&) noexcept { operator delete (p); }
+
+void operator delete (void* p, std::align_val_t) noexcept
+{
+    if (p != nullptr)
+        RealtimeGuard::report ("operator delete");
+    RealtimeGuard::freeAligned (p);
+}
+
+void operator delete[] (void* p, std::align_val_t alignment) noexcept { operator delete (p, alignment); }
+void operator delete (void* p, std::size_t, std::align_val_t alignment) noexcept { operator delete (p, alignment); }
+void operator delete[] (void* p, std::size_t, std::align_val_t alignment) noexcept { operator delete (p, alignment); }
+
+#if defined(__linux__) && defined(__GLIBC__)
+namespace RealtimeGuard
+{
+    // The real function behind an interposed one. Resolved on first use
+    // without a static guard, which could itself lock.
+    template <typename Fn>
+    Fn next (std::atomic<void*>& cache, const char* name) noexcept
+    {
+        auto* fn = cache.load (std::memory_order_acquire);
+        if (fn == nullptr)
+        {
+            fn = dlsym (RTLD_NEXT, name);
+            cache.store (fn, std::memory_order_release);
+        }
+        return reinterpret_cast<Fn> (fn);
+    }
+}
+
+    #define REALTIME_GUARD_NEXT(name) \
+        [] { static std::atomic<void*> cache { nullptr }; return RealtimeGuard::next<decltype (&::name)> (cache, #name); }()
+
+extern "C"
+{
+    // glibc's own entry points, so the allocator never goes through dlsym,
+    // which allocates
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void __libc_free (void*);
+
+    void* malloc (size_t size) noexcept
+    {
+        RealtimeGuard::report ("malloc");
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t num, size_t size) noexcept
+    {
+        RealtimeGuard::report ("calloc");
+        return __libc_calloc (num, size);
+    }
+
+    void* realloc (void* p, size_t size) noexcept
+    {
+        RealtimeGuard::report ("realloc");
+        return __libc_realloc (p, size);
+    }
+
+    void free (void* p) noexcept
+    {
+        if (p != nullptr)
+            RealtimeGuard::report ("free");
+        __libc_free (p);
+    }
+
+    int posix_memalign (void** result, size_t alignment, size_t size) noexcept
+    {
+        RealtimeGuard::report ("posix_memalign");
+        *result = __libc_memalign (alignment, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void* aligned_alloc (size_t alignment, size_t size) noexcept
+    {
+        RealtimeGuard::report ("aligned_alloc");
+        return __libc_memalign (alignment, size);
+    }
+
+    int pthread_mutex_lock (pthread_mutex_t* mutex) noexcept
+    {
+        RealtimeGuard::report ("pthread_mutex_lock");
+        return REALTIME_GUARD_NEXT (pthread_mutex_lock) (mutex);
+    }
+
+    int pthread_rwlock_rdlock (pthread_rwlock_t* lock) noexcept
+    {
+        RealtimeGuard::report ("pthread_rwlock_rdlock");
+        return REALTIME_GUARD_NEXT (pthread_rwlock_rdlock) (lock);
+    }
+
+    int pthread_rwlock_wrlock (pthread_rwlock_t* lock) noexcept
+    {
+        RealtimeGuard::report ("pthread_rwlock_wrlock");
+        return REALTIME_GUARD_NEXT (pthread_rwlock_wrlock) (lock);
+    }
+
+    // read() and open() are left out: with _FORTIFY_SOURCE the headers
+    // define them inline, and a second definition won't compile
+    ssize_t write (int fd, const void* data, size_t size)
+    {
+        RealtimeGuard::report ("write");
+        return REALTIME_GUARD_NEXT (write) (fd, data, size);
+    }
+
+    int nanosleep (const timespec* duration, timespec* remaining)
+    {
+        RealtimeGuard::report ("nanosleep");
+        return REALTIME_GUARD_NEXT (nanosleep) (duration, remaining);
+    }
+
+    int clock_nanosleep (clockid_t clock, int flags, const timespec* duration, timespec* remaining)
+    {
+        RealtimeGuard::report ("clock_nanosleep");
+        return REALTIME_GUARD_NEXT (clock_nanosleep) (clock, flags, duration, remaining);
+    }
+
+    int usleep (useconds_t microseconds)
+    {
+        RealtimeGuard::report ("usleep");
+        return REALTIME_GUARD_NEXT (usleep) (microseconds);
+    }
+
+    int sched_yield() noexcept
+    {
+        RealtimeGuard::report ("sched_yield");
+        return REALTIME_GUARD_NEXT (sched_yield)();
+    }
+}
+
+    #undef REALTIME_GUARD_NEXT
+#endif
+
+//==============================================================================
+namespace
+{
+    constexpr int maxBlockSize = 512;
+
+    void setParameter (PluginProcessor& p, const juce::String& id, float value)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    template <typename SampleType>
+    void fillNoise (juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, static_cast<SampleType> (random.nextFloat() * 2.0f - 1.0f));
+    }
+
+    // One block's worth of host events, every parameter at a random offset,
+    // in the sorted order a host sends them
+    std::vector<ParameterEvent> makeStorm (juce::Random& random, int numSamples)
+    {
+        std::vector<ParameterEvent> events;
+        for (int i = 0; i < PluginProcessor::NumParameters; ++i)
+            events.push_back ({ i, random.nextInt (numSamples), random.nextFloat() });
+
+        std::sort (events.begin(), events.end(), [] (const auto& a, const auto& b) { return a.sampleOffset < b.sampleOffset; });
+        return events;
+    }
+
+    // Runs one block on this thread under the guard. The buffer is resized
+    // to numSamples beforehand, outside it, without reallocating.
+    template <typename SampleType>
+    int processGuarded (PluginProcessor& p, juce::AudioBuffer<SampleType>& buffer, int numSamples, const std::vector<ParameterEvent>& events = {})
+    {
+        buffer.setSize (buffer.getNumChannels(), numSamples, true, false, true);
+        juce::MidiBuffer midi;
+
+        RealtimeGuard::Scope guard;
+        for (const auto& event : events)
+            p.queueParameterEvent (event.parameterIndex, event.sampleOffset, event.normalisedValue);
+        p.processBlock (buffer, midi);
+        return RealtimeGuard::violations();
+    }
+
+    // Parameter storm: every block carries an event for every parameter, and
+    // between blocks the host moves a few more the usual way
+    template <typename SampleType>
+    void runStorm (PluginProcessor& p, juce::Random& random, int numBlocks)
+    {
+        juce::AudioBuffer<SampleType> buffer (2, maxBlockSize);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                auto* param = p.getParameters()[random.nextInt (PluginProcessor::NumParameters)];
+                param->setValueNotifyingHost (random.nextFloat());
+            }
+
+            const int numSamples = 1 + random.nextInt (maxBlockSize);
+            const auto events    = makeStorm (random, numSamples);
+            fillNoise (buffer, random);
+
+            const int violations = processGuarded (p, buffer, numSamples, events);
+            INFO ("block " << block << ", " << numSamples << " samples");
+            INFO (RealtimeGuard::describe());
+            REQUIRE (violations == 0);
+        }
+    }
+}
+
+//==============================================================================
+TEST_CASE ("The real-time guard catches what it should", "[realtime]")
+{
+    {
+        RealtimeGuard::Scope guard;
+        auto* leak = new int (1);
+        delete leak;
+    }
+    CHECK (RealtimeGuard::violations() >= 2);
+
+#if defined(__linux__) && defined(__GLIBC__)
+    std::mutex mutex;
+    {
+        RealtimeGuard::Scope guard;
+        const std::scoped_lock lock (mutex);
+    }
+    CHECK (RealtimeGuard::violations() == 1);
+#endif
+
+    {
+        RealtimeGuard::Scope guard;
+        int onTheStack[16] {};
+        juce::ignoreUnused (onTheStack);
+    }
+    CHECK (RealtimeGuard::violations() == 0);
+}
+
+TEST_CASE ("processBlock survives a parameter storm without allocating or locking", "[realtime][params]")
+{
+    // Every switch changes mid-stream: the first guarded block after each
+    // setParameter() is the one that switches, with latency reported later
+    // from the message thread.
+    PluginProcessor p;
+    juce::Random random (15);
+
+    for (int i = 0; i < PluginProcessor::numBands; ++i)
+        setParameter (p, PluginProcessor::getParameterID (PluginProcessor::bandParameterIndex (i, PluginProcessor::BandParameter::Dynamic)), 1.0f);
+
+    SECTION ("Minimum phase, every oversampling setting, topology and stereo mode")
+    {
+        for (auto precision : { juce::AudioProcessor::singlePrecision, juce::AudioProcessor::doublePrecision })
+        {
+            p.setProcessingPrecision (precision);
+            p.prepareToPlay (48000.0, maxBlockSize);
+
+            for (int order = 0; order <= PluginProcessor::maxOversamplingOrder; ++order)
+            {
+                for (int filter = 0; filter < 2; ++filter)
+                {
+                    for (int topology = 0; topology < 2; ++topology)
+                    {
+                        for (int stereoMode = 0; stereoMode < 3; ++stereoMode)
+                        {
+                            setParameter (p, "oversampling", (float) order);
+                            setParameter (p, "oversamplingFilter", (float) filter);
+                            setParameter (p, "filterTopology", (float) topology);
+                            setParameter (p, "stereoMode", (float) stereoMode);
+
+                            if (precision == juce::AudioProcessor::doublePrecision)
+                                runStorm<double> (p, random, 8);
+                            else
+                                runStorm<float> (p, random, 8);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION ("Into and out of linear phase, at every oversampling setting")
+    {
+        // Starting in linear phase builds its engine, which stays built
+        // whichever mode the audio thread then switches to
+        setParameter (p, "phaseMode", 1.0f);
+
+        for (auto precision : { juce::AudioProcessor::singlePrecision, juce::AudioProcessor::doublePrecision })
+        {
+            p.setProcessingPrecision (precision);
+            p.prepareToPlay (48000.0, maxBlockSize);
+
+            for (int order = 0; order <= PluginProcessor::maxOversamplingOrder; ++order)
+            {
+                for (int phaseMode : { 0, 1 })
+                {
+                    setParameter (p, "oversampling", (float) order);
+                    setParameter (p, "phaseMode", (float) phaseMode);
+
+                    if (precision == juce::AudioProcessor::doublePrecision)
+                        runStorm<double> (p, random, 8);
+                    else
+                        runStorm<float> (p, random, 8);
+
+                    p.reportLatency();
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE ("processBlock stays real-time safe across sample rates and block sizes", "[realtime]")
+{
+    // Odd sizes, a single sample, and the maximum, in an order no host would keep to
+    constexpr std::array<int, 9> blockSizes { maxBlockSize, 1, 7, 64, 333, 2, maxBlockSize - 1, 128, 31 };
+
+    for (const auto& bus : { juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create7point1point4() })
+    {
+        PluginProcessor p;
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (bus);
+        layout.inputBuses.add (juce::AudioChannelSet::disabled()); // no sidechain
+        layout.outputBuses.add (bus);
+        REQUIRE (p.setBusesLayout (layout));
+
+        setParameter (p, "lowGain", 9.0f);
+        setParameter (p, "oversampling", 1.0f);
+
+        // As with an editor open. Nothing reads the FIFOs, so they fill up
+        // and the pushes take the dropping path too.
+        p.setAnalyserEnabled (true);
+
+        juce::Random random (16);
+
+        for (const auto sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 })
+        {
+            p.prepareToPlay (sampleRate, maxBlockSize);
+            juce::AudioBuffer<float> buffer (bus.size(), maxBlockSize);
+
+            for (const auto numSamples : blockSizes)
+            {
+                fillNoise (buffer, random);
+                const int violations = processGuarded (p, buffer, numSamples);
+                INFO (sampleRate << " Hz, " << numSamples << " samples, " << bus.getDescription());
+                INFO (RealtimeGuard::describe());
+                REQUIRE (violations == 0);
+            }
+
+            // Ring out into the silence bypass, then wake back up
+            const auto silentBlocks = (int) std::ceil (p.getTailLengthSeconds() * sampleRate / maxBlockSize) + 4;
+            for (int block = 0; block <= silentBlocks; ++block)
+            {
+                buffer.clear();
+                const int violations = processGuarded (p, buffer, maxBlockSize);
+                INFO (sampleRate << " Hz, silent block " << block);
+                INFO (RealtimeGuard::describe());
+                REQUIRE (violations == 0);
+            }
+
+            fillNoise (buffer, random);
+            const int violations = processGuarded (p, buffer, 100);
+            INFO (sampleRate << " Hz, waking");
+            INFO (RealtimeGuard::describe());
+            REQUIRE (violations == 0);
+        }
+    }
+}
+
+TEST_CASE ("Program changes apply on the audio thread without allocating or locking", "[realtime][presets]")
+{
+    juce::StringArray ids;
+    for (int i = 0; i < PluginProcessor::NumParameters; ++i)
+        ids.add (PluginProcessor::getParameterID (i));
+
+    PluginProcessor p;
+    juce::Random random (17);
+
+    std::vector<PresetBank::Preset> presets (16);
+    for (auto& preset : presets)
+    {
+        for (int i = 0; i < PluginProcessor::NumParameters; ++i)
+        {
+            auto* param = p.apvts.getParameter (ids[i]);
+            preset.values.push_back (param->convertFrom0to1 (random.nextFloat()));
+        }
+    }
+
+    juce::TemporaryFile temp (".mjpb");
+    {
+        juce::FileOutputStream out (temp.getFile());
+        REQUIRE (out.openedOk());
+        PresetBank::write (out, ids, presets);
+    }
+
+    REQUIRE (p.loadPresetBank (temp.getFile()));
+    p.prepareToPlay (48000.0, maxBlockSize);
+
+    juce::AudioBuffer<float> buffer (2, maxBlockSize);
+    juce::MidiBuffer midi;
+
+    for (int block = 0; block < 64; ++block)
+    {
+        const int program = random.nextInt ((int) presets.size());
+        fillNoise (buffer, random);
+
+        int violations = 0;
+        {
+            // The host's program change arrives on the audio thread too
+            RealtimeGuard::Scope guard;
+            p.setCurrentProgram (program);
+            p.processBlock (buffer, midi);
+            violations = RealtimeGuard::violations();
+        }
+
+        INFO ("program " << program);
+        INFO (RealtimeGuard::describe());
+        REQUIRE (violations == 0);
+    }
+}
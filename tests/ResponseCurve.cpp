@@ -0,0 +1,93 @@
+#include <PluginProcessor.h>
+#include <ResponseCurveDisplay.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <complex>
+
+namespace
+{
+    double directDb (const BiquadCoefficients<double>& c, double freq, double sampleRate)
+    {
+        const auto z1 = std::polar (1.0, -juce::MathConstants<double>::twoPi * freq / sampleRate);
+        const auto z2 = z1 * z1;
+        return 20.0 * std::log10 (std::abs ((c.b0 + c.b1 * z1 + c.b2 * z2) / (1.0 + c.a1 * z1 + c.a2 * z2)));
+    }
+
+    void setParameter (PluginProcessor& p, const juce::String& id, float value)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+}
+
+TEST_CASE ("Response curve matches the filters it is drawn from", "[response]")
+{
+    constexpr int numBands = 3;
+    constexpr std::array<BandType, numBands> types { BandType::LowShelf, BandType::PeakBell, BandType::HighShelf };
+
+    // Extremes included: a 20 Hz shelf at 192 kHz is where the cos (w) form falls apart
+    const std::array<std::array<double, 3>, numBands> settings { { { 20.0, 12.0, 0.707 }, { 1000.0, -9.0, 4.0 }, { 12000.0, 6.0, 0.707 } } };
+
+    for (const auto sampleRate : { 44100.0, 48000.0, 192000.0 })
+    {
+        ResponseCurve<numBands> curve;
+        curve.setSampleRate (sampleRate);
+
+        std::array<BiquadCoefficients<double>, numBands> coefficients;
+        for (int band = 0; band < numBands; ++band)
+        {
+            const auto& s = settings[(size_t) band];
+            coefficients[(size_t) band] = FilterDesign::makeBand<double> (types[(size_t) band], sampleRate, s[0], s[1], s[2]);
+            curve.setBand (band, coefficients[(size_t) band]);
+        }
+
+        const auto* total = curve.getTotalDb();
+
+        for (int point = 0; point < ResponseCurve<numBands>::numPoints; point += 5)
+        {
+            const auto freq = ResponseCurve<numBands>::frequencyAt (point);
+            if (freq >= 0.5 * sampleRate)
+                break;
+
+            double expected = 0.0;
+            for (int band = 0; band < numBands; ++band)
+            {
+                const auto bandDb = directDb (coefficients[(size_t) band], freq, sampleRate);
+                CHECK (curve.getBandDb (band, point) == Catch::Approx (bandDb).margin (0.01));
+                expected += bandDb;
+            }
+
+            INFO (sampleRate << " Hz, " << freq << " Hz");
+            CHECK (total[point] == Catch::Approx (expected).margin (0.02));
+        }
+    }
+}
+
+TEST_CASE ("Response curve display only redraws what moved", "[response]")
+{
+    PluginProcessor p;
+    setParameter (p, "midQ", 8.0f);
+    setParameter (p, "midQB", 8.0f);
+
+    ResponseCurveDisplay display (p);
+    display.setSize (600, 140);
+
+    // Nothing moved
+    CHECK (display.refresh().isEmpty());
+
+    // A narrow bell only touches the middle of the curve
+    setParameter (p, "midGain", 6.0f);
+    const auto dirty = display.refresh();
+    CHECK_FALSE (dirty.isEmpty());
+    CHECK (dirty.getX() > 0);
+    CHECK (dirty.getRight() < display.getWidth());
+    CHECK (dirty.getWidth() < display.getWidth() / 2);
+
+    CHECK (display.refresh().isEmpty());
+
+    // Switching set redraws straight away; set B is flat, so that's where the bell was
+    display.setChannelSet (1);
+    CHECK (display.refresh().isEmpty());
+    setParameter (p, "midGainB", 6.0f);
+    CHECK (display.refresh() == dirty);
+}
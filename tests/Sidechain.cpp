@@ -0,0 +1,151 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize     = 512;
+
+    void setParameter (PluginProcessor& p, const juce::String& id, float value)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    juce::AudioProcessor::BusesLayout layoutWithKey (const juce::AudioChannelSet& key)
+    {
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (juce::AudioChannelSet::stereo());
+        layout.inputBuses.add (key);
+        layout.outputBuses.add (juce::AudioChannelSet::stereo());
+        return layout;
+    }
+
+    // Half a second of a 1 kHz sine through p, with a 200 Hz key at keyLevel
+    // on the sidechain if it has one. Returns the last block.
+    juce::AudioBuffer<float> renderWithKey (PluginProcessor& p, float keyLevel)
+    {
+        p.prepareToPlay (sampleRate, blockSize);
+
+        const int numMain = p.getMainBusNumInputChannels();
+        juce::AudioBuffer<float> buffer (p.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+
+        for (int position = 0; position < (int) sampleRate / 2; position += blockSize)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                const auto t = (double) (position + i) / sampleRate;
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    buffer.setSample (ch, i, ch < numMain ? 0.25f * (float) std::sin (juce::MathConstants<double>::twoPi * 1000.0 * t)
+                                                          : keyLevel * (float) std::sin (juce::MathConstants<double>::twoPi * 200.0 * t));
+            }
+
+            p.processBlock (buffer, midi);
+        }
+
+        return buffer;
+    }
+
+    float rmsDb (const juce::AudioBuffer<float>& buffer)
+    {
+        return juce::Decibels::gainToDecibels (buffer.getRMSLevel (0, 0, buffer.getNumSamples()));
+    }
+}
+
+TEST_CASE ("Ducker follows its key on a fixed grid", "[dsp][sidechain]")
+{
+    Ducker<float> ducker;
+    ducker.prepare (sampleRate);
+    ducker.setAmounts (-30.0f, 12.0f);
+
+    std::vector<float> key (4800, 0.5f), audio (4800, 1.0f);
+    const float* keys[] = { key.data() };
+    float* channels[] = { audio.data() };
+
+    // Loud key, in odd lengths: pinned at the range
+    for (int position = 0; position < (int) key.size();)
+    {
+        const int numSamples = juce::jmin (37, (int) key.size() - position);
+        const float* keyAt[] = { key.data() + position };
+        float* audioAt[] = { audio.data() + position };
+        ducker.process (keyAt, 1, audioAt, 1, numSamples);
+        position += numSamples;
+    }
+
+    CHECK (ducker.getReductionDb() == Catch::Approx (12.0f));
+    CHECK (juce::Decibels::gainToDecibels (audio.back()) == Catch::Approx (-12.0f).margin (0.01));
+
+    // The gain moves in ramps a step long, never in jumps
+    float largestJump = 0.0f;
+    for (size_t i = 1; i < audio.size(); ++i)
+        largestJump = juce::jmax (largestJump, std::abs (audio[i] - audio[i - 1]));
+    CHECK (largestJump < 1.0f / (float) Ducker<float>::stepSize);
+
+    // A quiet key lets go, at the release rate
+    key.assign (48000, 0.0f);
+    audio.assign (48000, 1.0f);
+    keys[0]     = key.data();
+    channels[0] = audio.data();
+    ducker.process (keys, 1, channels, 1, (int) key.size());
+    CHECK (ducker.getReductionDb() == 0.0f);
+    CHECK (audio.back() == 1.0f);
+}
+
+TEST_CASE ("The sidechain bus is optional, mono or stereo", "[sidechain]")
+{
+    PluginProcessor p;
+
+    CHECK (p.isBusesLayoutSupported (layoutWithKey (juce::AudioChannelSet::disabled())));
+    CHECK (p.isBusesLayoutSupported (layoutWithKey (juce::AudioChannelSet::mono())));
+    CHECK (p.isBusesLayoutSupported (layoutWithKey (juce::AudioChannelSet::stereo())));
+    CHECK_FALSE (p.isBusesLayoutSupported (layoutWithKey (juce::AudioChannelSet::create5point1())));
+
+    // Off by default, so nothing changes for a host that never connects it
+    CHECK (p.getTotalNumInputChannels() == 2);
+}
+
+TEST_CASE ("A loud key ducks the master gain by the range", "[sidechain]")
+{
+    auto levelWith = [] (int target, float keyLevel, bool connected) {
+        PluginProcessor p;
+        if (connected)
+            REQUIRE (p.setBusesLayout (layoutWithKey (juce::AudioChannelSet::stereo())));
+
+        setParameter (p, "duckTarget", (float) target);
+        setParameter (p, "duckThreshold", -30.0f);
+        setParameter (p, "duckRange", 12.0f);
+        return rmsDb (renderWithKey (p, keyLevel));
+    };
+
+    const auto dry = levelWith (PluginProcessor::duckTargetOff, 0.5f, true);
+
+    CHECK (levelWith (PluginProcessor::duckTargetMaster, 0.5f, true) == Catch::Approx (dry - 12.0f).margin (0.2));
+
+    // Under the threshold, or without a sidechain, it stays out of the way
+    CHECK (levelWith (PluginProcessor::duckTargetMaster, 0.001f, true) == dry);
+    CHECK (levelWith (PluginProcessor::duckTargetMaster, 0.5f, false) == dry);
+}
+
+TEST_CASE ("A ducked band is cut, the rest of the spectrum isn't", "[sidechain]")
+{
+    constexpr int band = PluginProcessor::numBands / 2;
+    const auto freqID = PluginProcessor::getParameterID (PluginProcessor::bandParameterIndex (band, PluginProcessor::BandParameter::Freq));
+
+    auto levelWith = [&] (int target, float bandFreq) {
+        PluginProcessor p;
+        REQUIRE (p.setBusesLayout (layoutWithKey (juce::AudioChannelSet::stereo())));
+
+        setParameter (p, "duckTarget", (float) target);
+        setParameter (p, "duckRange", 12.0f);
+        setParameter (p, freqID, bandFreq);
+        return rmsDb (renderWithKey (p, 0.5f));
+    };
+
+    const auto dry = levelWith (PluginProcessor::duckTargetOff, 1000.0f);
+
+    // A bell cut of 12 dB right on the sine, then the same bell well away from it
+    CHECK (levelWith (PluginProcessor::duckTargetBand (band), 1000.0f) == Catch::Approx (dry - 12.0f).margin (0.5));
+    CHECK (levelWith (PluginProcessor::duckTargetBand (band), 8000.0f) == Catch::Approx (dry).margin (1.0));
+}
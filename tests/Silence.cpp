@@ -0,0 +1,152 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize     = 512;
+
+    void setParameter (PluginProcessor& p, const juce::String& id, float value)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    void fill (juce::AudioBuffer<float>& buffer, float value)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::fill (buffer.getWritePointer (ch), value, buffer.getNumSamples());
+    }
+
+    void fillNoise (juce::AudioBuffer<float>& buffer, int seed)
+    {
+        juce::Random random (seed);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+    }
+
+    // A 100 Hz bell with a long ring, so the tail spans many blocks
+    void setUpRingingBell (PluginProcessor& p)
+    {
+        setParameter (p, "lowFreq", 100.0f);
+        setParameter (p, "lowGain", 12.0f);
+        setParameter (p, "lowQ", 4.0f);
+        p.prepareToPlay (sampleRate, blockSize);
+    }
+}
+
+TEST_CASE ("Band decay times bound the measured impulse response", "[dsp][silence]")
+{
+    struct Case { BandType type; double freq, gainDb, q; };
+
+    for (const auto& c : { Case { BandType::PeakBell, 100.0, 12.0, 4.0 },
+                           Case { BandType::PeakBell, 1000.0, -12.0, 10.0 },
+                           Case { BandType::LowShelf, 50.0, 12.0, 0.707 },
+                           Case { BandType::LowShelf, 200.0, -12.0, 2.0 },
+                           Case { BandType::HighShelf, 5000.0, -12.0, 0.3 } })
+    {
+        BiquadCascade<double, 1, 1> band;
+        band.setCoefficients (0, FilterDesign::makeBand (c.type, sampleRate, c.freq, c.gainDb, c.q));
+
+        std::vector<double> h ((size_t) sampleRate * 10);
+        h[0] = 1.0;
+        double* const channels[] = { h.data() };
+        band.process (channels, 1, (int) h.size(), [] { return 1.0; });
+
+        size_t last = 0;
+        for (size_t i = 1; i < h.size(); ++i)
+            if (std::abs (h[i]) > 1.0e-6)
+                last = i;
+
+        const auto measured = (double) last / sampleRate;
+        const auto estimate = FilterDesign::decaySeconds (c.type, c.freq, c.gainDb, c.q, 120.0);
+
+        CHECK (measured <= estimate);
+        CHECK (measured >= 0.5 * estimate);
+    }
+
+    CHECK (FilterDesign::decaySeconds (BandType::PeakBell, 100.0, 0.0, 10.0, 120.0) == 0.0);
+}
+
+TEST_CASE ("Tail length follows the bands", "[params][silence]")
+{
+    PluginProcessor p;
+    p.prepareToPlay (sampleRate, blockSize);
+
+    // A flat EQ is a wire
+    CHECK (p.getTailLengthSeconds() == 0.0);
+
+    setUpRingingBell (p);
+    const auto ringing = p.getTailLengthSeconds();
+    CHECK (ringing > 0.2);
+
+    setParameter (p, "lowQ", 8.0f);
+    p.prepareToPlay (sampleRate, blockSize);
+    CHECK (p.getTailLengthSeconds() > ringing);
+}
+
+TEST_CASE ("Silent input is passed through once the tail has rung out", "[dsp][silence]")
+{
+    PluginProcessor p;
+    setUpRingingBell (p);
+
+    juce::AudioBuffer<float> buffer (2, blockSize);
+    juce::MidiBuffer midi;
+
+    fillNoise (buffer, 1);
+    p.processBlock (buffer, midi);
+
+    // Inside the tail the filters still ring, so the output is not the input
+    fill (buffer, 0.0f);
+    p.processBlock (buffer, midi);
+    CHECK (buffer.getMagnitude (0, 0, blockSize) > 1.0e-3f);
+
+    const auto tailBlocks = (int) std::ceil (p.getTailLengthSeconds() * sampleRate / blockSize);
+    for (int block = 0; block < tailBlocks; ++block)
+    {
+        fill (buffer, 0.0f);
+        p.processBlock (buffer, midi);
+    }
+
+    // Past it, input under the threshold comes out untouched, not at the 0.5 master gain
+    fill (buffer, 1.0e-7f);
+    p.processBlock (buffer, midi);
+    CHECK (buffer.getSample (0, 0) == 1.0e-7f);
+    CHECK (buffer.getSample (1, blockSize - 1) == 1.0e-7f);
+}
+
+TEST_CASE ("Waking from silence sounds like a fresh start", "[dsp][silence]")
+{
+    PluginProcessor sleeper, fresh;
+    setUpRingingBell (sleeper);
+    setUpRingingBell (fresh);
+
+    juce::AudioBuffer<float> buffer (2, blockSize), expected (2, blockSize);
+    juce::MidiBuffer midi;
+
+    fillNoise (buffer, 2);
+    sleeper.processBlock (buffer, midi);
+
+    for (int block = 0; block < 200; ++block)
+    {
+        fill (buffer, 0.0f);
+        sleeper.processBlock (buffer, midi);
+    }
+
+    // A change made while bypassed lands as soon as audio comes back
+    setParameter (sleeper, "midGain", -6.0f);
+    setParameter (fresh, "midGain", -6.0f);
+    fill (buffer, 0.0f);
+    sleeper.processBlock (buffer, midi);
+    fresh.prepareToPlay (sampleRate, blockSize);
+
+    fillNoise (buffer, 3);
+    fillNoise (expected, 3);
+    sleeper.processBlock (buffer, midi);
+    fresh.processBlock (expected, midi);
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < blockSize; ++i)
+            REQUIRE (buffer.getSample (ch, i) == expected.getSample (ch, i));
+}
@@ -0,0 +1,134 @@
+#include <PluginProcessor.h>
+#include <SpectrumAnalyser.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    // A sine whose period fits the FFT a whole number of times, so it lands on one bin
+    template <typename SampleType>
+    void fillSine (juce::AudioBuffer<SampleType>& buffer, int bin, SampleType amplitude, int startSample = 0)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, amplitude * (SampleType) std::sin (juce::MathConstants<double>::twoPi * bin * (startSample + i) / SpectrumAnalysis::fftSize));
+    }
+}
+
+TEST_CASE ("Analyser FIFO keeps order and mixes down to mono", "[analyser]")
+{
+    AnalyserFifo fifo;
+    fifo.prepare (64);
+
+    std::array<float, 40> left {}, right {};
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        left[i]  = (float) i;
+        right[i] = (float) i + 2.0f;
+    }
+    const float* channels[] { left.data(), right.data() };
+
+    std::array<float, 64> out {};
+
+    // Twice round the ring, so the second push wraps
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        REQUIRE (fifo.push (channels, 2, 40) == 40);
+        REQUIRE (fifo.pop (out.data(), (int) out.size()) == 40);
+
+        for (size_t i = 0; i < 40; ++i)
+            CHECK (out[i] == Catch::Approx ((float) i + 1.0f));
+    }
+
+    SECTION ("Double precision input")
+    {
+        std::array<double, 3> a { 0.5, -1.0, 0.25 }, b { 0.5, 1.0, 0.75 };
+        const double* doubles[] { a.data(), b.data() };
+        REQUIRE (fifo.push (doubles, 2, 3) == 3);
+        REQUIRE (fifo.pop (out.data(), 3) == 3);
+        CHECK (out[0] == 0.5f);
+        CHECK (out[1] == 0.0f);
+        CHECK (out[2] == 0.5f);
+    }
+
+    SECTION ("A full FIFO drops new samples rather than waiting")
+    {
+        CHECK (fifo.push (channels, 2, 40) == 40);
+        CHECK (fifo.push (channels, 2, 40) == 63 - 40);
+        CHECK (fifo.push (channels, 2, 40) == 0);
+
+        // The oldest survive
+        REQUIRE (fifo.pop (out.data(), 1) == 1);
+        CHECK (out[0] == Catch::Approx (1.0f));
+    }
+}
+
+TEST_CASE ("Spectrum analysis puts a sine in its bin", "[analyser]")
+{
+    constexpr int bin = 100;
+
+    AnalyserFifo fifo;
+    fifo.prepare (SpectrumAnalysis::fftSize * 2);
+
+    juce::AudioBuffer<float> buffer (1, SpectrumAnalysis::fftSize);
+    fillSine (buffer, bin, 0.5f);
+    fifo.push (buffer.getArrayOfReadPointers(), 1, buffer.getNumSamples());
+
+    SpectrumAnalysis analysis;
+    analysis.pull (fifo);
+    analysis.update();
+
+    CHECK (analysis.getLevel (bin) == Catch::Approx (-6.0f).margin (0.1f));
+    CHECK (analysis.getLevel (bin + 20) < -80.0f);
+    CHECK (analysis.getLevel (bin - 20) < -80.0f);
+
+    // Peaks hold through silence and fall away over a few frames
+    buffer.clear();
+    fifo.push (buffer.getArrayOfReadPointers(), 1, buffer.getNumSamples());
+    analysis.pull (fifo);
+    analysis.update();
+
+    const auto afterOneFrame = analysis.getLevel (bin);
+    CHECK (afterOneFrame < -6.0f);
+    CHECK (afterOneFrame > -40.0f);
+
+    for (int frame = 0; frame < 120; ++frame)
+        analysis.update();
+    CHECK (analysis.getLevel (bin) < -100.0f);
+}
+
+TEST_CASE ("processBlock feeds the analyser only while it is enabled", "[analyser]")
+{
+    PluginProcessor p;
+    p.apvts.getParameter ("masterGain")->setValueNotifyingHost (p.apvts.getParameter ("masterGain")->convertTo0to1 (-6.0f));
+    p.prepareToPlay (48000.0, 512);
+
+    juce::AudioBuffer<float> buffer (2, 512);
+    juce::MidiBuffer midi;
+    auto& pre  = p.getAnalyserFifo (false);
+    auto& post = p.getAnalyserFifo (true);
+
+    p.processBlock (buffer, midi);
+    CHECK_FALSE (pre.isPrepared());
+
+    SpectrumAnalyser analyser (p);
+    REQUIRE (pre.isPrepared());
+
+    // Long enough for the gain to settle, then one whole FFT's worth
+    SpectrumAnalysis in, out;
+    for (int start = 0; start < 4 * SpectrumAnalysis::fftSize; start += buffer.getNumSamples())
+    {
+        fillSine (buffer, 64, 0.5f, start);
+        p.processBlock (buffer, midi);
+        CHECK (pre.getNumReady() == buffer.getNumSamples());
+        CHECK (post.getNumReady() == buffer.getNumSamples());
+
+        in.pull (pre);
+        out.pull (post);
+    }
+
+    in.update();
+    out.update();
+    CHECK (in.getLevel (64) == Catch::Approx (-6.0f).margin (0.1f));
+    CHECK (out.getLevel (64) == Catch::Approx (-12.0f).margin (0.2f));
+}
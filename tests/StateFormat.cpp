@@ -0,0 +1,133 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+
+namespace
+{
+    void setParameter (PluginProcessor& p, const juce::String& id, float value)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+
+    float plainValue (PluginProcessor& p, const juce::String& id)
+    {
+        auto* param = p.apvts.getParameter (id);
+        return param->convertFrom0to1 (param->getValue());
+    }
+
+    // Every parameter, switches included, somewhere away from its default
+    void scramble (PluginProcessor& p, int seed)
+    {
+        juce::Random random (seed);
+        for (auto* param : p.getParameters())
+            param->setValueNotifyingHost (random.nextFloat());
+    }
+
+    void writeRecord (juce::MemoryOutputStream& out, const juce::String& id, float plain)
+    {
+        out.writeInt ((int) id.hashCode());
+        out.writeFloat (plain);
+    }
+}
+
+TEST_CASE ("Binary state restores every parameter", "[state]")
+{
+    PluginProcessor p;
+    scramble (p, 1);
+
+    juce::MemoryBlock state;
+    p.getStateInformation (state);
+
+    // A header and eight bytes a parameter, nothing else
+    CHECK (StateFormat::isBinary (state.getData(), (int) state.getSize()));
+    CHECK (state.getSize() == StateFormat::headerSize + StateFormat::recordSize * (size_t) p.getParameters().size());
+
+    PluginProcessor p2;
+    scramble (p2, 2);
+    p2.setStateInformation (state.getData(), (int) state.getSize());
+
+    for (int i = 0; i < p.getParameters().size(); ++i)
+        CHECK (p2.getParameters()[i]->getValue() == Catch::Approx (p.getParameters()[i]->getValue()).margin (1.0e-6));
+}
+
+TEST_CASE ("Parameter IDs hash to distinct keys", "[state]")
+{
+    PluginProcessor p;
+    std::set<juce::uint32> hashes;
+    for (auto* param : p.getParameters())
+        CHECK (hashes.insert (StateFormat::hashOf (param)).second);
+}
+
+TEST_CASE ("XML states from earlier versions still load", "[state]")
+{
+    PluginProcessor p;
+    setParameter (p, "lowGain", 6.0f);
+    setParameter (p, "midFreqB", 3000.0f);
+    setParameter (p, "oversampling", 2.0f);
+
+    // What getStateInformation() used to write
+    juce::MemoryBlock state;
+    std::unique_ptr<juce::XmlElement> xml (p.apvts.copyState().createXml());
+    juce::AudioProcessor::copyXmlToBinary (*xml, state);
+    REQUIRE_FALSE (StateFormat::isBinary (state.getData(), (int) state.getSize()));
+
+    PluginProcessor p2;
+    p2.setStateInformation (state.getData(), (int) state.getSize());
+
+    CHECK (plainValue (p2, "lowGain") == Catch::Approx (6.0f).epsilon (0.01f));
+    CHECK (plainValue (p2, "midFreqB") == Catch::Approx (3000.0f).epsilon (0.01f));
+    CHECK (plainValue (p2, "oversampling") == Catch::Approx (2.0f));
+}
+
+TEST_CASE ("Binary states match parameters by ID, not position", "[state]")
+{
+    // Out of order, one unknown parameter, and most of ours missing
+    juce::MemoryBlock state;
+    {
+        juce::MemoryOutputStream out (state, false);
+        out.writeInt ((int) StateFormat::magic);
+        out.writeShort ((short) StateFormat::version);
+        out.writeShort (3);
+        writeRecord (out, "midGain", -4.0f);
+        writeRecord (out, "retiredParameter", 123.0f);
+        writeRecord (out, "lowGain", 6.0f);
+    }
+
+    PluginProcessor p;
+    setParameter (p, "highGain", 9.0f);
+    p.setStateInformation (state.getData(), (int) state.getSize());
+
+    CHECK (plainValue (p, "lowGain") == Catch::Approx (6.0f).epsilon (0.01f));
+    CHECK (plainValue (p, "midGain") == Catch::Approx (-4.0f).epsilon (0.01f));
+
+    // Left out of the state, so back to the default
+    auto* highGain = p.apvts.getParameter ("highGain");
+    CHECK (highGain->getValue() == Catch::Approx (highGain->getDefaultValue()));
+}
+
+TEST_CASE ("Truncated or newer binary states are ignored", "[state]")
+{
+    PluginProcessor p;
+    setParameter (p, "lowGain", 6.0f);
+
+    juce::MemoryBlock state;
+    p.getStateInformation (state);
+
+    PluginProcessor p2;
+    setParameter (p2, "lowGain", -3.0f);
+
+    SECTION ("Truncated")
+    {
+        p2.setStateInformation (state.getData(), (int) state.getSize() - 1);
+        CHECK (plainValue (p2, "lowGain") == Catch::Approx (-3.0f).epsilon (0.01f));
+    }
+
+    SECTION ("Newer version")
+    {
+        static_cast<char*> (state.getData())[4] = (char) (StateFormat::version + 1);
+        p2.setStateInformation (state.getData(), (int) state.getSize());
+        CHECK (plainValue (p2, "lowGain") == Catch::Approx (-3.0f).epsilon (0.01f));
+    }
+}
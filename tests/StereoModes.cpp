@@ -0,0 +1,174 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numSamples    = 2000;
+    constexpr std::array<BandType, 3> bandTypes { BandType::LowShelf, BandType::PeakBell, BandType::HighShelf };
+
+    using Chain = EqChain<float, BiquadTopology, 3>;
+
+    // Set A's bands are 0-2 and set B's 3-5
+    void setUpSet (Chain& eq, int set, float gainDb)
+    {
+        eq.snapBand (set * 3 + 0, 200.0f, gainDb, 0.707f);
+        eq.snapBand (set * 3 + 1, 1000.0f, -gainDb, 2.0f);
+        eq.snapBand (set * 3 + 2, 8000.0f, gainDb, 0.707f);
+    }
+
+    std::vector<float> makeNoise (int seed)
+    {
+        std::vector<float> x ((size_t) numSamples);
+        juce::Random random (seed);
+        for (auto& s : x)
+            s = random.nextFloat() * 2.0f - 1.0f;
+        return x;
+    }
+
+    // Runs a single channel through a linked chain with set A as given
+    std::vector<float> renderLinked (std::vector<float> x, float gainDb)
+    {
+        Chain eq { bandTypes };
+        eq.prepare (sampleRate);
+        setUpSet (eq, 0, gainDb);
+
+        float* const channels[] = { x.data() };
+        eq.process (channels, 1, numSamples, [] { return 1.0f; });
+        return x;
+    }
+
+    void setParameter (PluginProcessor& p, const juce::String& id, float value)
+    {
+        auto* param = p.apvts.getParameter (id);
+        param->setValueNotifyingHost (param->convertTo0to1 (value));
+    }
+}
+
+TEST_CASE ("Left/right mode runs each set on its own channel", "[dsp][stereo]")
+{
+    auto left  = makeNoise (1);
+    auto right = makeNoise (2);
+    const auto expectedLeft  = renderLinked (left, 6.0f);
+    const auto expectedRight = renderLinked (right, -9.0f);
+
+    Chain eq { bandTypes };
+    eq.prepare (sampleRate);
+    eq.setStereoMode (StereoMode::LeftRight);
+    setUpSet (eq, 0, 6.0f);
+    setUpSet (eq, 1, -9.0f);
+
+    float* const channels[] = { left.data(), right.data() };
+    eq.process (channels, 2, numSamples, [] { return 1.0f; });
+
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        REQUIRE (left[i] == Catch::Approx (expectedLeft[i]).margin (1.0e-6));
+        REQUIRE (right[i] == Catch::Approx (expectedRight[i]).margin (1.0e-6));
+    }
+}
+
+TEST_CASE ("Mid/side mode with matching sets sounds like linked", "[dsp][stereo]")
+{
+    // Filtering mid and side separately rounds differently, hence the wider margin
+    auto left  = makeNoise (3);
+    auto right = makeNoise (4);
+    const auto expectedLeft  = renderLinked (left, 6.0f);
+    const auto expectedRight = renderLinked (right, 6.0f);
+
+    Chain eq { bandTypes };
+    eq.prepare (sampleRate);
+    eq.setStereoMode (StereoMode::MidSide);
+    setUpSet (eq, 0, 6.0f);
+    setUpSet (eq, 1, 6.0f);
+
+    float* const channels[] = { left.data(), right.data() };
+    eq.process (channels, 2, numSamples, [] { return 1.0f; });
+
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        REQUIRE (left[i] == Catch::Approx (expectedLeft[i]).margin (1.0e-4));
+        REQUIRE (right[i] == Catch::Approx (expectedRight[i]).margin (1.0e-4));
+    }
+}
+
+TEST_CASE ("Side bands leave a mono signal alone", "[dsp][stereo]")
+{
+    auto left  = makeNoise (5);
+    auto right = left;
+    const auto expected = renderLinked (left, 3.0f);
+
+    Chain eq { bandTypes };
+    eq.prepare (sampleRate);
+    eq.setStereoMode (StereoMode::MidSide);
+    setUpSet (eq, 0, 3.0f);
+    setUpSet (eq, 1, 12.0f);
+    eq.rampBand (4, 3000.0f, 12.0f, 1.0f);
+
+    float* const channels[] = { left.data(), right.data() };
+    eq.process (channels, 2, numSamples, [] { return 1.0f; });
+
+    for (size_t i = 0; i < left.size(); ++i)
+    {
+        REQUIRE (left[i] == Catch::Approx (expected[i]).margin (1.0e-4));
+        REQUIRE (right[i] == Catch::Approx (expected[i]).margin (1.0e-4));
+    }
+}
+
+TEST_CASE ("stereoMode puts set B on the right channel", "[dsp][params][stereo]")
+{
+    constexpr int blockSize = 1024;
+
+    auto render = [] (int stereoMode, const juce::AudioChannelSet& bus) {
+        PluginProcessor p;
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add (bus);
+        layout.inputBuses.add (juce::AudioChannelSet::disabled()); // no sidechain
+        layout.outputBuses.add (bus);
+        REQUIRE (p.setBusesLayout (layout));
+
+        setParameter (p, "stereoMode", (float) stereoMode);
+        setParameter (p, "midGainB", 12.0f);
+        p.prepareToPlay (sampleRate, blockSize);
+
+        const int numChannels = bus.size();
+        juce::AudioBuffer<float> buffer (numChannels, blockSize);
+        juce::Random random (9);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        const juce::AudioBuffer<float> input (buffer);
+        juce::MidiBuffer midi;
+        p.processBlock (buffer, midi);
+
+        // How far each channel moved from input * the default 0.5 master gain
+        std::vector<float> deviation ((size_t) numChannels);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                deviation[(size_t) ch] = juce::jmax (deviation[(size_t) ch], std::abs (buffer.getSample (ch, i) - 0.5f * input.getSample (ch, i)));
+
+        return deviation;
+    };
+
+    SECTION ("Linked ignores set B")
+    {
+        const auto deviation = render (0, juce::AudioChannelSet::stereo());
+        CHECK (deviation[0] < 1.0e-5f);
+        CHECK (deviation[1] < 1.0e-5f);
+    }
+
+    SECTION ("Left/right filters only the right channel with set B")
+    {
+        const auto deviation = render (2, juce::AudioChannelSet::stereo());
+        CHECK (deviation[0] < 1.0e-5f);
+        CHECK (deviation[1] > 0.1f);
+    }
+
+    SECTION ("Split modes fall back to linked on other buses")
+    {
+        const auto deviation = render (2, juce::AudioChannelSet::mono());
+        CHECK (deviation[0] < 1.0e-5f);
+    }
+}
@@ -0,0 +1,104 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    void processBlocks (PluginProcessor& p, int numBlocks, int blockSize)
+    {
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random (23);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample (ch, i, random.nextFloat() - 0.5f);
+
+            p.processBlock (buffer, midi);
+        }
+    }
+}
+
+TEST_CASE ("Telemetry histogram buckets", "[telemetry]")
+{
+    // Everything under the first octave shares the first bucket, and the top one takes the rest
+    CHECK (Telemetry::bucketFor (0) == 0);
+    CHECK (Telemetry::bucketFor (63) == 0);
+    CHECK (Telemetry::bucketFor (juce::uint64 (1) << 62) == Telemetry::numBuckets - 1);
+
+    for (juce::uint64 nanos = 64; nanos < 100'000'000; nanos = nanos * 9 / 8 + 1)
+    {
+        const auto bucket = Telemetry::bucketFor (nanos);
+        INFO (nanos << " ns");
+        CHECK (Telemetry::bucketLowerBound (bucket) <= (double) nanos);
+        CHECK (Telemetry::bucketLowerBound (bucket + 1) > (double) nanos);
+    }
+
+    Telemetry::Snapshot snapshot;
+    snapshot.count[Telemetry::Block] = 100;
+    snapshot.histogram[Telemetry::Block][(size_t) Telemetry::bucketFor (1000)]   = 98;
+    snapshot.histogram[Telemetry::Block][(size_t) Telemetry::bucketFor (50000)]  = 2;
+
+    CHECK (snapshot.percentileNanos (Telemetry::Block, 0.5) == Telemetry::bucketLowerBound (Telemetry::bucketFor (1000) + 1));
+    CHECK (snapshot.percentileNanos (Telemetry::Block, 0.99) == Telemetry::bucketLowerBound (Telemetry::bucketFor (50000) + 1));
+}
+
+TEST_CASE ("processBlock reports its timings", "[telemetry]")
+{
+    constexpr int blockSize = 256, numBlocks = 50;
+
+    PluginProcessor p;
+    p.prepareToPlay (48000.0, blockSize);
+
+    const auto before = p.getTelemetry();
+    processBlocks (p, numBlocks, blockSize);
+    const auto after = p.getTelemetry();
+
+    if constexpr (! Telemetry::enabled)
+    {
+        // Compiled out: the API is still there and reads as zeros
+        CHECK (after.count[Telemetry::Block] == 0);
+        CHECK (after.samples == 0);
+        return;
+    }
+
+    CHECK (after.count[Telemetry::Block] - before.count[Telemetry::Block] == numBlocks);
+    CHECK (after.samples - before.samples == numBlocks * blockSize);
+    CHECK (after.count[Telemetry::GainLoop] - before.count[Telemetry::GainLoop] >= numBlocks);
+
+    // The sections are inside the block
+    CHECK (after.totalNanos[Telemetry::GainLoop] - before.totalNanos[Telemetry::GainLoop]
+           <= after.totalNanos[Telemetry::Block] - before.totalNanos[Telemetry::Block]);
+    CHECK (after.worstNanos[Telemetry::Block] >= (juce::uint64) after.meanNanos (Telemetry::Block));
+    CHECK (after.percentileNanos (Telemetry::Block, 0.99, before) > 0.0);
+
+    const auto load = after.loadSince (before, 48000.0);
+    CHECK (load > 0.0);
+    CHECK (load < 1.0);
+}
+
+TEST_CASE ("Coefficient designs are counted only when something changes", "[telemetry]")
+{
+    if constexpr (! Telemetry::enabled)
+        return;
+
+    PluginProcessor p;
+    p.prepareToPlay (48000.0, 256);
+    processBlocks (p, 4, 256);
+
+    // Settled: nothing to redesign
+    const auto idle = p.getTelemetry();
+    processBlocks (p, 20, 256);
+    CHECK (p.getTelemetry().coefficientDesigns == idle.coefficientDesigns);
+
+    // A gain change ramps, redesigning that band every control step
+    auto* gain = p.apvts.getParameter ("midGain");
+    gain->setValueNotifyingHost (gain->convertTo0to1 (6.0f));
+    processBlocks (p, 20, 256);
+
+    const auto moved = p.getTelemetry();
+    CHECK (moved.coefficientDesigns > idle.coefficientDesigns);
+    CHECK (moved.count[Telemetry::Filters] > idle.count[Telemetry::Filters]);
+}
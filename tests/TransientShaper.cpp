@@ -0,0 +1,94 @@
+#include <PluginProcessor.h>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+
+    // Silence, then a 1 kHz hit that decays with a 100 ms time constant
+    std::vector<float> hit (int numSamples, int onset)
+    {
+        std::vector<float> x ((size_t) numSamples);
+        for (int i = onset; i < numSamples; ++i)
+        {
+            const double t = (i - onset) / sampleRate;
+            x[(size_t) i] = (float) (std::exp (-t / 0.1) * std::sin (juce::MathConstants<double>::twoPi * 1000.0 * t));
+        }
+        return x;
+    }
+
+    float peak (const std::vector<float>& x, std::pair<int, int> window)
+    {
+        float p = 0.0f;
+        for (int i = window.first; i < window.second; ++i)
+            p = std::max (p, std::abs (x[(size_t) i]));
+        return p;
+    }
+
+    std::vector<float> shape (float attackDb, float sustainDb, const std::vector<float>& input)
+    {
+        TransientShaper<float> shaper;
+        shaper.setAmounts (attackDb, sustainDb);
+        shaper.prepare (sampleRate);
+
+        auto output = input;
+        float* const channels[] = { output.data() };
+        shaper.process (channels, 1, (int) output.size());
+        return output;
+    }
+}
+
+TEST_CASE ("TransientShaper leaves audio alone at 0 dB", "[dsp]")
+{
+    const auto input  = hit (4096, 1000);
+    const auto output = shape (0.0f, 0.0f, input);
+
+    for (size_t i = 0; i < input.size(); ++i)
+        REQUIRE (output[i] == input[i]);
+}
+
+TEST_CASE ("TransientShaper boosts attacks and cuts sustains", "[dsp]")
+{
+    constexpr int onset = 1000;
+    const auto input = hit (24000, onset);
+
+    // The first 5 ms after the onset is the attack. From 200 ms on the hit is
+    // well into its decay, where the fast envelope sits under the slow one.
+    const auto attackWindow  = std::pair { onset, onset + 240 };
+    const auto sustainWindow = std::pair { onset + 9600, onset + 14400 };
+
+    auto change = [&input] (const std::vector<float>& output, std::pair<int, int> window) {
+        return peak (output, window) / peak (input, window);
+    };
+
+    const auto punchy = shape (9.0f, 0.0f, input);
+    CHECK (change (punchy, attackWindow) > 2.0f);
+    CHECK (change (punchy, sustainWindow) == Catch::Approx (1.0f).margin (0.01f));
+
+    const auto tight = shape (0.0f, -9.0f, input);
+    CHECK (change (tight, attackWindow) == Catch::Approx (1.0f).margin (0.01f));
+    CHECK (change (tight, sustainWindow) < 0.5f);
+}
+
+TEST_CASE ("TransientShaper applies one gain to every channel", "[dsp]")
+{
+    // An onset on the left only still shapes the right by the same amount,
+    // and blocks longer than a chunk go through seamlessly.
+    const int numSamples = TransientShaper<float>::chunkSize * 5 + 17;
+    auto left  = hit (numSamples, 300);
+    auto right = std::vector<float> ((size_t) numSamples, 0.25f);
+    const auto original = right;
+
+    TransientShaper<float> shaper;
+    shaper.setAmounts (6.0f, -6.0f);
+    shaper.prepare (sampleRate);
+
+    float* const channels[] = { left.data(), right.data() };
+    shaper.process (channels, 2, numSamples);
+
+    const auto reference = hit (numSamples, 300);
+    for (size_t i = 0; i < left.size(); ++i)
+        if (std::abs (reference[i]) > 0.1f)
+            REQUIRE (left[i] / reference[i] == Catch::Approx (right[i] / original[i]).epsilon (1.0e-5));
+}